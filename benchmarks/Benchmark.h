@@ -0,0 +1,78 @@
+/**
+* Minimal timing harness shared by the benchmarks in this directory.
+* Each result is printed as one JSON object per line so runs can be appended
+* to a log and diffed or plotted over time.
+*
+* The benchmarks build against the same course template files the games do,
+* none of which are tracked here. Copy them next to project_3/main.cpp
+* first, since every build line below searches ../project_3 for headers:
+*   glm/             headers only, needed by every benchmark
+*   ShaderProgram.h  needed by every benchmark
+*   ShaderProgram.cpp  only render_golden, for GLRenderBackend
+*   stb_image.h      hot_paths and render_golden, through common/Texture.cpp
+* plus SDL2's headers. Only hot_paths and render_golden link against GL.
+**/
+#include <chrono>
+#include <iostream>
+#include <string>
+
+struct BenchmarkResult
+{
+    std::string name;
+    long long   iterations;
+    long long   items;
+    double      total_ms;
+    
+    double ns_per_iteration() const { return total_ms * 1000000.0 / iterations;           };
+    double ns_per_item()      const { return total_ms * 1000000.0 / (iterations * items); };
+};
+
+inline void report(const BenchmarkResult& result)
+{
+    std::cout << "{\"name\":\"" << result.name << "\""
+              << ",\"iterations\":" << result.iterations
+              << ",\"items\":" << result.items
+              << ",\"total_ms\":" << result.total_ms
+              << ",\"ns_per_iteration\":" << result.ns_per_iteration()
+              << ",\"ns_per_item\":" << result.ns_per_item()
+              << "}" << std::endl;
+}
+
+// Runs body() until at least min_ms has elapsed, doubling the batch each
+// round so the clock is read rarely compared to the work being measured.
+template <typename Body>
+BenchmarkResult run_benchmark(const std::string& name, long long items, Body body, double min_ms = 200.0)
+{
+    for (int i = 0; i < 3; i++) body();
+    
+    long long iterations = 0;
+    long long batch = 1;
+    double elapsed = 0.0;
+    
+    while (elapsed < min_ms)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < batch; i++) body();
+        auto end = std::chrono::steady_clock::now();
+        
+        elapsed += std::chrono::duration<double, std::milli>(end - start).count();
+        iterations += batch;
+        batch *= 2;
+    }
+    
+    BenchmarkResult result = {name, iterations, items, elapsed};
+    report(result);
+    return result;
+}
+
+// Keeps the optimiser from discarding results that are otherwise unused.
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+    (void) *sink;
+#endif
+}
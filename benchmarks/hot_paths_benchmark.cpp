@@ -0,0 +1,108 @@
+/**
+* Microbenchmarks for the per-frame hot paths of project_2 and project_3:
+* Entity::update, Entity::check_collision, draw_text vertex generation,
+* load_texture decoding and Pong's check_collision.
+*
+* Build from this directory, for example:
+*   g++ -O2 -std=c++11 $(sdl2-config --cflags) -I../project_3 -I../project_2 hot_paths_benchmark.cpp ../project_3/Entity.cpp ../project_3/ContactEvents.cpp ../project_3/Utility.cpp ../common/Texture.cpp ../project_3/FrameArena.cpp ../project_3/AllocationTracker.cpp ../project_2/Pong.cpp -lGL -o hot_paths_benchmark
+* See Benchmark.h for the untracked files the build needs.
+*   ./hot_paths_benchmark [path/to/project_3/assets/] >> results.jsonl
+**/
+#define GL_SILENCE_DEPRECATION
+#define GL_GLEXT_PROTOTYPES 1
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include <string>
+#include <vector>
+#include "../common/MeshRegistry.h"
+#include "Entity.h"
+#include "../common/Texture.h"
+#include "Utility.h"
+#include "Pong.h"
+#include "Benchmark.h"
+
+int main(int argc, char* argv[])
+{
+    std::string assets = argc > 1 ? argv[1] : "../project_3/assets/";
+    
+    // Same layout as project_3's initialise()
+    Entity platforms[2];
+    platforms[0].set_position(glm::vec3(2.25f, -3.8f, 0.0f));
+    platforms[0].set_width(1.0f);
+    platforms[0].set_height(3.0f);
+    platforms[1].set_position(glm::vec3(4.0f, -1.9f, 0.0f));
+    platforms[1].set_width(2.0f);
+    platforms[1].set_height(4.0f);
+    
+    Entity player;
+    player.set_type(PLAYER);
+    player.speed = 1.0f;
+    player.set_acceleration(glm::vec3(0.0f, -1.5f, 0.0f));
+    
+    run_benchmark("entity_update_airborne", 1, [&]() {
+        player.set_position(glm::vec3(-4.0f, 4.0f, 0.0f));
+        player.update(FIXED_TIMESTEP, platforms, 2);
+        do_not_optimize(player.model_matrix);
+    });
+    
+    run_benchmark("entity_update_resting", 1, [&]() {
+        player.set_position(glm::vec3(4.0f, 0.6f, 0.0f));
+        player.set_velocity(glm::vec3(0.0f, -0.1f, 0.0f));
+        player.update(FIXED_TIMESTEP, platforms, 2);
+        do_not_optimize(player.model_matrix);
+    });
+    
+    Entity other;
+    other.set_position(glm::vec3(0.5f, 0.5f, 0.0f));
+    player.set_position(glm::vec3(0.0f));
+    
+    run_benchmark("entity_check_collision", 1, [&]() {
+        bool hit = player.check_collision(&other);
+        do_not_optimize(hit);
+    });
+    
+    std::string short_text = "LOSE";
+    std::string long_text(64, 'A');
+    std::vector<float> vertices(long_text.size() * 12);
+    std::vector<float> texture_coordinates(long_text.size() * 12);
+    
+    run_benchmark("draw_text_vertices_4", (long long) short_text.size(), [&]() {
+        Utility::build_text_vertices(short_text, 0.8f, 0.5f, vertices.data(), texture_coordinates.data());
+        do_not_optimize(vertices.data());
+    });
+    
+    run_benchmark("draw_text_vertices_64", (long long) long_text.size(), [&]() {
+        Utility::build_text_vertices(long_text, 0.8f, 0.5f, vertices.data(), texture_coordinates.data());
+        do_not_optimize(vertices.data());
+    });
+    
+    const char* images[] = {"bbird.png", "font.png", "mizore.png"};
+    for (const char* image : images)
+    {
+        std::string path = assets + image;
+        run_benchmark(std::string("load_texture_decode_") + image, 1, [&]() {
+            int width, height;
+            unsigned char* pixels = Utility::decode_image(path.c_str(), &width, &height);
+            do_not_optimize(pixels);
+            Utility::free_image(pixels);
+        });
+    }
+    
+    glm::vec3 paddle = glm::vec3(-4.5f, 0.0f, 0.0f);
+    glm::vec3 ball   = glm::vec3(-4.3f, 0.2f, 0.0f);
+    
+    run_benchmark("pong_check_collision", 1, [&]() {
+        bool hit = check_collision(paddle, ball);
+        do_not_optimize(hit);
+    });
+    
+    return 0;
+}
@@ -0,0 +1,175 @@
+/**
+* Headless throughput of LanderBatch: N independent landers fed random input,
+* reported as instance-steps per second (items = instances x steps), after a
+* cross-check of a few instances against Entity::update, ContactQueue and the
+* game's win/lose rules. Default sweep is 1k to 1M; pass counts to override,
+* e.g. ./lander_batch_benchmark 4096 65536.
+*
+* Build from this directory, for example:
+*   g++ -O3 -march=native -std=c++11 -pthread $(sdl2-config --cflags) -I../project_3 lander_batch_benchmark.cpp ../project_3/LanderBatch.cpp ../project_3/Entity.cpp ../project_3/ContactEvents.cpp -o lander_batch_benchmark
+* See Benchmark.h for the untracked headers the build needs.
+* Without -march=native most step loops stay scalar: plain SSE2 has no blend
+* for the lane-wise selects.
+**/
+#define GL_SILENCE_DEPRECATION
+#define GL_GLEXT_PROTOTYPES 1
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../common/MeshRegistry.h"
+#include "Entity.h"
+#include "ContactEvents.h"
+#include "LanderBatch.h"
+#include "Benchmark.h"
+
+const float FIXED_TIMESTEP = 0.0166666f;
+const int   STEPS          = 600;
+const int   CHECKED_INSTANCES = 16;
+
+// Random keys held for runs of a few dozen steps, so landers actually drift
+// into the platforms instead of jittering in place
+std::vector<unsigned char> make_inputs(int instance_count, int steps)
+{
+    std::vector<unsigned char> inputs((size_t) instance_count * steps);
+    for (int i = 0; i < instance_count; i++)
+    {
+        unsigned char keys = 0;
+        for (int step = 0; step < steps; step++)
+        {
+            if (rand() % 30 == 0) keys = rand() % 8;
+            inputs[(size_t) step * instance_count + i] = keys;
+        }
+    }
+    return inputs;
+}
+
+// The game's loop for one lander, one fixed step per frame
+LanderOutcome run_reference(const unsigned char *inputs, int instance_count, int index, int steps, glm::vec3& final_position)
+{
+    Entity platforms[2];
+    platforms[0].set_position(glm::vec3(2.25f, -3.8f, 0.0f));
+    platforms[0].set_width(1.0f);
+    platforms[0].set_height(3.0f);
+    platforms[1].set_position(glm::vec3(4.0f, -1.9f, 0.0f));
+    platforms[1].set_width(2.0f);
+    platforms[1].set_height(4.0f);
+    
+    Entity player;
+    player.set_type(PLAYER);
+    player.speed = 1.0f;
+    player.set_position(glm::vec3(-4.0f, 4.0f, 0.0f));
+    player.set_acceleration(glm::vec3(0.0f, -1.5f, 0.0f));
+    
+    ContactQueue contacts;
+    LanderOutcome outcome = LANDER_FLYING;
+    
+    for (int step = 0; step < steps && outcome == LANDER_FLYING; step++)
+    {
+        int keys = inputs[(size_t) step * instance_count + index];
+        glm::vec3 temp;
+        if (keys & LANDER_LEFT)
+        {
+            temp = player.get_acceleration();
+            temp.x -= 0.5f;
+            player.set_acceleration(temp);
+        }
+        else if (keys & LANDER_RIGHT)
+        {
+            temp = player.get_acceleration();
+            temp.x += 0.5f;
+            player.set_acceleration(temp);
+        }
+        if (keys & LANDER_THRUST)
+        {
+            temp = player.get_velocity();
+            temp.y += 0.05f;
+            player.set_velocity(temp);
+        }
+        
+        player.update(FIXED_TIMESTEP, platforms, 2, &contacts);
+        contacts.end_step();
+        
+        for (int i = 0; i < contacts.get_event_count() && outcome == LANDER_FLYING; i++)
+        {
+            const ContactEvent& contact = contacts.get_event(i);
+            if (contact.entity != &player || contact.phase == CONTACT_END) continue;
+            
+            if (contact.normal.x != 0.0f) outcome = LANDER_LOST;
+        }
+        for (int i = 0; i < contacts.get_event_count() && outcome == LANDER_FLYING; i++)
+        {
+            const ContactEvent& contact = contacts.get_event(i);
+            if (contact.entity != &player || contact.phase == CONTACT_END) continue;
+            
+            if (contact.normal.y > 0.0f) {
+                outcome = contact.position.y < -1.0f && contact.position.x >= 2.25f ? LANDER_WON : LANDER_LOST;
+            }
+        }
+        contacts.clear_events();
+        
+        glm::vec3 position = player.get_position();
+        if (outcome == LANDER_FLYING && (position.y < -4.5f || position.x < -5.5f || position.x > 5.5f)) outcome = LANDER_LOST;
+    }
+    
+    final_position = player.get_position();
+    return outcome;
+}
+
+int cross_check(const unsigned char *inputs, LanderBatch& batch, int steps)
+{
+    int mismatches = 0;
+    int instance_count = batch.get_count();
+    
+    for (int k = 0; k < CHECKED_INSTANCES && k < instance_count; k++)
+    {
+        int index = k * (instance_count / CHECKED_INSTANCES > 0 ? instance_count / CHECKED_INSTANCES : 1);
+        glm::vec3 position;
+        LanderOutcome expected = run_reference(inputs, instance_count, index, steps, position);
+        
+        if (expected != batch.get_outcome(index) || position.x != batch.get_position_x(index) || position.y != batch.get_position_y(index))
+        {
+            std::cout << "Mismatch at instance " << index << ": game " << expected << " (" << position.x << ", " << position.y
+                      << "), batch " << batch.get_outcome(index) << " (" << batch.get_position_x(index) << ", " << batch.get_position_y(index) << ")" << std::endl;
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+void run_batch(int instance_count)
+{
+    std::vector<unsigned char> inputs = make_inputs(instance_count, STEPS);
+    LanderBatch batch(instance_count);
+    
+    batch.run(inputs.data(), STEPS);
+    int mismatches = cross_check(inputs.data(), batch, STEPS);
+    if (mismatches > 0) std::cout << mismatches << " of " << CHECKED_INSTANCES << " checked landers disagree with the game" << std::endl;
+    
+    run_benchmark("lander_batch_" + std::to_string(instance_count), (long long) instance_count * STEPS, [&]() {
+        batch.reset_all(LanderParameters());
+        batch.run(inputs.data(), STEPS);
+        do_not_optimize(batch.get_position_x(0));
+    }, 500.0);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<int> counts;
+    for (int i = 1; i < argc; i++) counts.push_back(atoi(argv[i]));
+    if (counts.empty()) counts = {1000, 10000, 100000, 1000000};
+    
+    srand(3113);
+    for (int count : counts) run_batch(count);
+    
+    return 0;
+}
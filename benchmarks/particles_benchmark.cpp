@@ -0,0 +1,66 @@
+/**
+* Headless benchmark for project_3's ParticleEmitter.
+* Keeps the pool saturated at 100k live particles and times update() plus the
+* batched vertex build for 600 fixed steps on a single thread.
+*
+* Build from this directory alongside project_3's sources, for example:
+*   g++ -O2 -std=c++11 $(sdl2-config --cflags) -I../project_3 particles_benchmark.cpp ../project_3/ParticleSystem.cpp -o particles_benchmark
+* See Benchmark.h for the untracked headers the build needs.
+**/
+#define GL_SILENCE_DEPRECATION
+#define GL_GLEXT_PROTOTYPES 1
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+#include "ParticleSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#define LOG(argument) std::cout << argument << '\n'
+
+const float FIXED_TIMESTEP = 1.0f / 60.0f;
+const float FRAME_BUDGET_MS = 1000.0f / 60.0f;
+const int WARMUP_FRAMES = 60;
+const int MEASURED_FRAMES = 600;
+
+int main(int argc, char* argv[])
+{
+    ParticleEmitter emitter(ParticleEmitter::MAX_PARTICLES);
+    emitter.acceleration = glm::vec3(0.0f, -1.5f, 0.0f);
+    
+    std::vector<double> frame_times;
+    frame_times.reserve(MEASURED_FRAMES);
+    
+    for (int frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; frame++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        
+        emitter.emit(glm::vec3(0.0f), glm::vec3(0.0f, 2.0f, 0.0f), 1.5f, 2.0f, emitter.get_capacity() - emitter.get_count());
+        emitter.update(FIXED_TIMESTEP);
+        emitter.build_vertices();
+        
+        auto end = std::chrono::steady_clock::now();
+        if (frame >= WARMUP_FRAMES) frame_times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    
+    std::sort(frame_times.begin(), frame_times.end());
+    double total = 0.0;
+    for (double time : frame_times) total += time;
+    
+    double mean = total / frame_times.size();
+    double p99  = frame_times[(int) (frame_times.size() * 0.99)];
+    
+    LOG("{\"name\":\"particles_sustained\",\"items\":" << emitter.get_capacity()
+        << ",\"mean_ms\":" << mean << ",\"p99_ms\":" << p99 << ",\"max_ms\":" << frame_times.back()
+        << ",\"budget_ms\":" << FRAME_BUDGET_MS << ",\"pass\":" << (p99 < FRAME_BUDGET_MS ? "true" : "false") << "}");
+    
+    return p99 < FRAME_BUDGET_MS ? 0 : 1;
+}
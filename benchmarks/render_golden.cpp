@@ -0,0 +1,200 @@
+/**
+* Renders project_3 scenes through SoftwareRenderBackend with no GPU or
+* display, compares each frame with a golden PPM and times the render path.
+*
+*   ./render_golden <assets dir> <golden dir> [--update]
+*   ./render_golden ../project_3/assets golden
+*
+* The reference images are committed in golden/. --update (re)writes them
+* instead of comparing; a scene that no longer matches leaves its frame next
+* to the golden as <scene>.actual.ppm. Exit code is the number of scenes that
+* no longer match.
+*
+* The sprites are generated fixture textures rather than the game's JPEG art,
+* whose decoded texels depend on the JPEG decoder; only the font comes from
+* assets/, and PNG decodes the same everywhere. Frames are rendered at the
+* game's 320x240 native size to keep the goldens small.
+*
+* Build from this directory, for example:
+*   g++ -O2 -std=c++11 -pthread $(sdl2-config --cflags) -I../project_3 render_golden.cpp ../project_3/Entity.cpp ../project_3/ContactEvents.cpp ../project_3/ParticleSystem.cpp ../project_3/Utility.cpp ../project_3/FrameArena.cpp ../project_3/AllocationTracker.cpp ../project_3/RenderBackend.cpp ../project_3/SoftwareRenderBackend.cpp ../project_3/ShaderProgram.cpp ../common/Texture.cpp ../common/MeshRegistry.cpp -lGL -o render_golden
+* ShaderProgram.cpp is the course template's, not tracked here; see Benchmark.h.
+**/
+#define GL_SILENCE_DEPRECATION
+#define GL_GLEXT_PROTOTYPES 1
+#define LOG(argument) std::cout << argument << '\n'
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../common/MeshRegistry.h"
+#include "Entity.h"
+#include "ParticleSystem.h"
+#include "../common/Texture.h"
+#include "Utility.h"
+#include "FrameArena.h"
+#include "RenderBackend.h"
+#include "SoftwareRenderBackend.h"
+#include "Benchmark.h"
+
+const int NATIVE_WIDTH  = 320,
+          NATIVE_HEIGHT = 240;
+
+const int GOLDEN_TOLERANCE = 2;
+
+// Quad shapes from project_3/main.cpp
+float bird[] = {-0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f};
+float mizo[] = {-1.0f, -2.0f, 1.0f, -2.0f, 1.0f, 2.0f, -1.0f, -2.0f, -1.0f, 2.0f, 1.0f, 2.0f};
+float hand[] = {-0.45f, -1.5f, 0.45f, -1.5f, 0.45f, 1.5f, -0.45f, -1.5f, -0.45f, 1.5f, 0.45f, 1.5f};
+const float FULL_TEXTURE_COORDS[] = {0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+
+// A two-colour checkerboard; round cuts it to the inscribed disc so the
+// transparent corners exercise blending
+GLuint add_fixture_texture(SoftwareRenderBackend& renderer, int size, int cell, const unsigned char first[4], const unsigned char second[4], bool round)
+{
+    std::vector<unsigned char> texels(size * size * 4);
+    float radius = size * 0.5f;
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            const unsigned char *colour = ((x / cell + y / cell) % 2 == 0) ? first : second;
+            unsigned char *texel = &texels[(y * size + x) * 4];
+            memcpy(texel, colour, 4);
+            
+            float dx = x + 0.5f - radius;
+            float dy = y + 0.5f - radius;
+            if (round && dx * dx + dy * dy > radius * radius) texel[3] = 0;
+        }
+    }
+    return renderer.add_texture(texels.data(), size, size);
+}
+
+GLuint load_software_texture(SoftwareRenderBackend& renderer, const std::string& filepath)
+{
+    int width, height;
+    unsigned char *image = Utility::decode_image(filepath.c_str(), &width, &height);
+    GLuint id = renderer.add_texture(image, width, height);
+    Utility::free_image(image);
+    return id;
+}
+
+struct Scene
+{
+    Entity player;
+    Entity platforms[2];
+    MeshHandle player_mesh;
+    MeshHandle platform_meshes[2];
+    ParticleEmitter particles;
+    GLuint font_texture_id;
+    const char *text;
+    
+    Scene() : particles(ParticleEmitter::MAX_PARTICLES), text(NULL) {}
+};
+
+void draw_scene(Scene& scene, RenderBackend *renderer, FrameArena *arena)
+{
+    renderer->begin_frame();
+    scene.player.render(renderer, scene.player_mesh);
+    scene.platforms[0].render(renderer, scene.platform_meshes[0]);
+    scene.platforms[1].render(renderer, scene.platform_meshes[1]);
+    scene.particles.render(renderer);
+    if (scene.text != NULL) Utility::draw_text(renderer, scene.font_texture_id, scene.text, 0.8f, 0.5f, glm::vec3(-2.0f, 1.0f, 0.0f), arena);
+    renderer->end_frame();
+    arena->reset();
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        LOG("usage: render_golden <assets dir> <golden dir> [--update]");
+        return -1;
+    }
+    std::string assets = std::string(argv[1]) + "/";
+    std::string goldens = std::string(argv[2]) + "/";
+    bool update = argc > 3 && strcmp(argv[3], "--update") == 0;
+    
+    SoftwareRenderBackend renderer(NATIVE_WIDTH, NATIVE_HEIGHT);
+    renderer.clear_colour[0] = renderer.clear_colour[1] = renderer.clear_colour[2] = 255;
+    renderer.set_view_projection(glm::mat4(1.0f), glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f));
+    FrameArena arena(64 * 1024);
+    
+    Scene scene;
+    scene.player_mesh        = MeshRegistry::register_mesh(bird, FULL_TEXTURE_COORDS, 6);
+    scene.platform_meshes[0] = MeshRegistry::register_mesh(hand, FULL_TEXTURE_COORDS, 6);
+    scene.platform_meshes[1] = MeshRegistry::register_mesh(mizo, FULL_TEXTURE_COORDS, 6);
+    const unsigned char blue[]  = {40, 90, 200, 255},  white[]  = {235, 235, 235, 255},
+                        green[] = {30, 150, 70, 255},  yellow[] = {240, 210, 60, 255},
+                        red[]   = {200, 40, 40, 255},  black[]  = {20, 20, 20, 255};
+    
+    scene.platforms[0].texture_id = add_fixture_texture(renderer, 32, 4, blue, white, false);
+    scene.platforms[0].set_position(glm::vec3(2.25f, -3.8f, 0.0f));
+    scene.platforms[0].update(0.0f, NULL, 0);
+    scene.platforms[1].texture_id = add_fixture_texture(renderer, 32, 8, green, yellow, false);
+    scene.platforms[1].set_position(glm::vec3(4.0f, -1.9f, 0.0f));
+    scene.platforms[1].update(0.0f, NULL, 0);
+    scene.player.texture_id = add_fixture_texture(renderer, 32, 4, red, black, true);
+    scene.player.set_position(glm::vec3(-4.0f, 4.0f, 0.0f));
+    scene.player.update(0.0f, NULL, 0);
+    scene.font_texture_id = load_software_texture(renderer, assets + "font.png");
+    
+    unsigned char particle_pixel[] = {255, 160, 40, 200};
+    scene.particles.texture_id = renderer.add_texture(particle_pixel, 1, 1);
+    scene.particles.size = 0.06f;
+    
+    int failures = 0;
+    const char *names[] = {"lander_start", "lander_lose", "lander_particles"};
+    
+    for (int i = 0; i < 3; i++)
+    {
+        if (i == 1)
+        {
+            scene.player.set_position(glm::vec3(4.0f, 0.6f, 0.0f));
+            scene.player.update(0.0f, NULL, 0);
+            scene.text = "LOSE";
+        }
+        if (i == 2)
+        {
+            // Fixed seed inside the emitter keeps this frame reproducible
+            scene.particles.emit(glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 2.5f, 10.0f, 10000);
+            scene.particles.update(0.5f);
+        }
+        
+        draw_scene(scene, &renderer, &arena);
+        
+        std::string golden = goldens + names[i] + ".ppm";
+        if (update)
+        {
+            if (!renderer.save_ppm(golden.c_str())) LOG("Could not write " << golden);
+            continue;
+        }
+        
+        int mismatches = renderer.compare_ppm(golden.c_str(), GOLDEN_TOLERANCE);
+        if (mismatches != 0)
+        {
+            failures++;
+            std::string actual = goldens + names[i] + ".actual.ppm";
+            renderer.save_ppm(actual.c_str());
+        }
+        LOG("{\"name\":\"golden_" << names[i] << "\",\"mismatched_pixels\":" << mismatches << "}");
+        
+        run_benchmark(std::string("software_render_") + names[i], 1, [&]() {
+            draw_scene(scene, &renderer, &arena);
+        });
+    }
+    
+    return failures;
+}
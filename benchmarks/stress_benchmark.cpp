@@ -0,0 +1,97 @@
+/**
+* Parameterised stress scenes for project_3: N landers falling onto the two
+* platforms, stepped with Entity::update exactly as the game does, and the
+* same N as live particles and as animated sprites. Default sweep is 10 to 100k; pass counts to
+* override, e.g. ./stress_benchmark 500 5000.
+*
+* Build from this directory, for example:
+*   g++ -O2 -std=c++11 $(sdl2-config --cflags) -I../project_3 stress_benchmark.cpp ../project_3/Entity.cpp ../project_3/ContactEvents.cpp ../project_3/ParticleSystem.cpp ../project_3/Animation.cpp -o stress_benchmark
+* See Benchmark.h for the untracked headers the build needs.
+**/
+#define GL_SILENCE_DEPRECATION
+#define GL_GLEXT_PROTOTYPES 1
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../common/MeshRegistry.h"
+#include "Entity.h"
+#include "ParticleSystem.h"
+#include "Animation.h"
+#include "Benchmark.h"
+
+const float FIXED_TIMESTEP = 1.0f / 60.0f;
+
+void run_entity_scene(int entity_count)
+{
+    Entity platforms[2];
+    platforms[0].set_position(glm::vec3(2.25f, -3.8f, 0.0f));
+    platforms[0].set_width(1.0f);
+    platforms[0].set_height(3.0f);
+    platforms[1].set_position(glm::vec3(4.0f, -1.9f, 0.0f));
+    platforms[1].set_width(2.0f);
+    platforms[1].set_height(4.0f);
+    
+    std::vector<Entity> landers(entity_count);
+    for (int i = 0; i < entity_count; i++)
+    {
+        landers[i].set_type(PLAYER);
+        landers[i].speed = 1.0f;
+        landers[i].set_position(glm::vec3(-4.5f + 9.0f * i / entity_count, 4.0f, 0.0f));
+        landers[i].set_acceleration(glm::vec3(0.0f, -1.5f, 0.0f));
+    }
+    
+    run_benchmark("stress_entity_update_" + std::to_string(entity_count), entity_count, [&]() {
+        for (int i = 0; i < entity_count; i++) landers[i].update(FIXED_TIMESTEP, platforms, 2);
+        do_not_optimize(landers.data());
+    }, 500.0);
+}
+
+void run_particle_scene(int particle_count)
+{
+    ParticleEmitter emitter(particle_count);
+    emitter.acceleration = glm::vec3(0.0f, -1.5f, 0.0f);
+    
+    run_benchmark("stress_particles_" + std::to_string(emitter.get_capacity()), emitter.get_capacity(), [&]() {
+        emitter.emit(glm::vec3(0.0f), glm::vec3(0.0f, 2.0f, 0.0f), 1.5f, 2.0f, emitter.get_capacity() - emitter.get_count());
+        emitter.update(FIXED_TIMESTEP);
+        emitter.build_vertices();
+    }, 500.0);
+}
+
+void run_animation_scene(int sprite_count)
+{
+    AnimationSystem animations;
+    int frames[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    int walk = animations.add_clip(4, 2, frames, 8, 12);
+    int idle = animations.add_clip(4, 2, frames, 2, Entity::SECONDS_PER_FRAME, false);
+    
+    for (int i = 0; i < sprite_count; i++) animations.add_sprite(i % 2 == 0 ? walk : idle);
+    
+    run_benchmark("stress_animation_" + std::to_string(sprite_count), sprite_count, [&]() {
+        animations.update(FIXED_TIMESTEP);
+        do_not_optimize(animations.get_tex_coords(sprite_count - 1));
+    }, 500.0);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<int> counts;
+    for (int i = 1; i < argc; i++) counts.push_back(atoi(argv[i]));
+    if (counts.empty()) counts = {10, 100, 1000, 10000, 100000};
+    
+    for (int count : counts) run_entity_scene(count);
+    for (int count : counts) run_particle_scene(count);
+    for (int count : counts) run_animation_scene(count);
+    
+    return 0;
+}
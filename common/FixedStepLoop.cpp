@@ -0,0 +1,52 @@
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <SDL.h>
+#include <iostream>
+#include "FixedStepLoop.h"
+
+FixedStepLoop::FixedStepLoop(float step, int max_steps_per_frame)
+{
+    step_seconds = step;
+    max_steps    = max_steps_per_frame;
+    reset();
+}
+
+void FixedStepLoop::reset()
+{
+    frequency        = SDL_GetPerformanceFrequency();
+    previous_counter = SDL_GetPerformanceCounter();
+    accumulator = 0.0;
+    alpha       = 0.0f;
+}
+
+int FixedStepLoop::begin_frame()
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    accumulator += (double) (now - previous_counter) / frequency;
+    previous_counter = now;
+    
+    int steps = (int) (accumulator / step_seconds);
+    if (steps > max_steps)
+    {
+        double kept = (double) max_steps * step_seconds;
+        dropped_seconds += accumulator - kept;
+        accumulator = kept;
+        steps = max_steps;
+        clamped_frames++;
+    }
+    accumulator -= steps * (double) step_seconds;
+    
+    alpha = (float) (accumulator / step_seconds);
+    total_steps += steps;
+    frame_count++;
+    return steps;
+}
+
+void FixedStepLoop::report() const
+{
+    if (frame_count == 0) return;
+    
+    LOG("Fixed step " << step_seconds * 1000.0f << " ms: " << total_steps << " steps over " << frame_count << " frames ("
+        << (double) total_steps / frame_count << " per frame), " << clamped_frames << " frames hit the "
+        << max_steps << "-step cap, " << dropped_seconds * 1000.0 << " ms dropped");
+}
@@ -0,0 +1,40 @@
+// Steps past this in one frame are dropped rather than simulated
+const int FIXED_STEP_MAX_CATCH_UP = 5;
+
+// Turns wall-clock time into a whole number of fixed simulation steps per
+// frame and carries the remainder over. After begin_frame, get_alpha says how
+// far the remainder reaches into the next step, so a renderer can blend the
+// state before the last step with the state after it and show motion at the
+// display rate whatever the step rate is. A frame that falls far behind (a
+// breakpoint, a window drag, an idle wait) runs at most max_steps steps and
+// the rest of its time is dropped, so a slow step cannot snowball into more
+// steps per frame.
+class FixedStepLoop
+{
+private:
+    float step_seconds;
+    int max_steps;
+    Uint64 frequency;
+    Uint64 previous_counter;
+    double accumulator = 0.0;
+    float alpha = 0.0f;
+    
+    long long total_steps = 0;
+    int frame_count       = 0;
+    int clamped_frames    = 0;
+    double dropped_seconds = 0.0;
+    
+public:
+    FixedStepLoop(float step, int max_steps_per_frame = FIXED_STEP_MAX_CATCH_UP);
+    
+    // Returns how many steps to run this frame
+    int begin_frame();
+    
+    // Restarts timing from now, e.g. once loading is done; a global loop is
+    // constructed before SDL_Init, so call this after it at least once
+    void reset();
+    void report() const;
+    
+    float const get_alpha() const { return alpha;        };
+    float const get_step()  const { return step_seconds; };
+};
@@ -0,0 +1,123 @@
+#define LOG(argument) std::cout << argument << '\n'
+
+#ifdef _WINDOWS
+#include <windows.h>
+#endif
+
+#include <SDL.h>
+#include <ctime>
+#include <iostream>
+#include "FramePacer.h"
+
+// CPU time used by the whole process, all threads, in milliseconds.
+// std::clock() cannot be used for this: MSVC's returns wall time.
+static double process_cpu_ms()
+{
+#ifdef _WINDOWS
+    FILETIME creation, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exited, &kernel, &user)) return 0.0;
+    
+    ULARGE_INTEGER kernel_time, user_time;
+    kernel_time.LowPart  = kernel.dwLowDateTime;
+    kernel_time.HighPart = kernel.dwHighDateTime;
+    user_time.LowPart    = user.dwLowDateTime;
+    user_time.HighPart   = user.dwHighDateTime;
+    
+    // FILETIME counts 100 ns ticks
+    return (kernel_time.QuadPart + user_time.QuadPart) / 10000.0;
+#else
+    timespec now;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now) != 0) return 0.0;
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+#endif
+}
+
+FramePacer::FramePacer(double target_fps)
+{
+    target_seconds = 1.0 / target_fps;
+    reset();
+}
+
+void FramePacer::reset()
+{
+    frequency    = SDL_GetPerformanceFrequency();
+    deadline     = SDL_GetPerformanceCounter();
+    frame_start  = deadline;
+    cpu_start_ms = process_cpu_ms();
+    work_marked  = false;
+}
+
+void FramePacer::detect_vsync(SDL_Window *window)
+{
+    SDL_DisplayMode mode;
+    int refresh_rate = SDL_GetWindowDisplayMode(window, &mode) == 0 ? mode.refresh_rate : 0;
+    
+    // Only let the swap do the pacing when it is not faster than our target;
+    // a 144 Hz display with vsync still needs limiting to 60
+    vsync_paced = SDL_GL_GetSwapInterval() != 0 && refresh_rate > 0 && refresh_rate <= 1.05 / target_seconds;
+    
+    LOG("Frame pacing: target " << 1.0 / target_seconds << " Hz, display " << refresh_rate << " Hz, "
+        << (vsync_paced ? "vsync paced" : "timer paced"));
+}
+
+void FramePacer::begin_frame()
+{
+    frame_start  = SDL_GetPerformanceCounter();
+    cpu_start_ms = process_cpu_ms();
+    work_marked  = false;
+}
+
+void FramePacer::end_work()
+{
+    work_end    = SDL_GetPerformanceCounter();
+    work_marked = true;
+}
+
+void FramePacer::end_frame(bool idle)
+{
+    Uint64 period = (Uint64) (target_seconds * frequency);
+    Uint64 work_stop = work_marked ? work_end : SDL_GetPerformanceCounter();
+    last_work_ms  = (work_stop - frame_start) * 1000.0 / frequency;
+    
+    if (idle)
+    {
+        // Leaves the event in the queue for process_input to handle
+        SDL_WaitEventTimeout(NULL, IDLE_TIMEOUT_MS);
+        idle_frames++;
+        deadline = SDL_GetPerformanceCounter();
+    }
+    else if (!vsync_paced)
+    {
+        deadline += period;
+        Uint64 now = SDL_GetPerformanceCounter();
+        
+        // Too far behind to catch up smoothly; start counting from now
+        if (now > deadline + period) deadline = now;
+        
+        if (deadline > now)
+        {
+            double remaining_ms = (deadline - now) * 1000.0 / frequency;
+            if (remaining_ms > spin_margin_ms) SDL_Delay((Uint32) (remaining_ms - spin_margin_ms));
+            while (SDL_GetPerformanceCounter() < deadline) {}
+        }
+    }
+    
+    // Taken after the wait so the spin, which is real CPU spent, is counted too
+    last_cpu_ms  = process_cpu_ms() - cpu_start_ms;
+    last_wall_ms = (SDL_GetPerformanceCounter() - frame_start) * 1000.0 / frequency;
+    
+    frame_count++;
+    total_wall_ms += last_wall_ms;
+    total_cpu_ms  += last_cpu_ms;
+    total_work_ms += last_work_ms;
+}
+
+void FramePacer::report() const
+{
+    if (frame_count == 0) return;
+    
+    LOG("Frames: " << frame_count << " (" << idle_frames << " idle), "
+        << total_wall_ms / frame_count << " ms wall / " << total_work_ms / frame_count << " ms work / "
+        << total_cpu_ms / frame_count << " ms CPU per frame, "
+        << 100.0 * total_cpu_ms / total_wall_ms << "% of one core");
+}
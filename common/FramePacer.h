@@ -0,0 +1,53 @@
+// Paces a main loop to a target rate instead of letting it spin a core.
+// Sleeps through most of the wait and spins only the last couple of
+// milliseconds, which SDL_Delay cannot hit precisely; steps aside when vsync
+// already blocks in SDL_GL_SwapWindow; and can block on input when nothing
+// on screen is changing.
+class FramePacer
+{
+private:
+    double target_seconds;
+    Uint64 frequency;
+    Uint64 deadline;
+    Uint64 frame_start;
+    Uint64 work_end;
+    bool work_marked = false;
+    double cpu_start_ms;
+    bool vsync_paced = false;
+    
+    int    frame_count   = 0;
+    int    idle_frames   = 0;
+    double total_wall_ms = 0.0;
+    double total_cpu_ms  = 0.0;
+    double total_work_ms = 0.0;
+    double last_wall_ms  = 0.0;
+    double last_cpu_ms   = 0.0;
+    // Wall time from begin_frame until end_work, or until the pacer started
+    // waiting if the frame never called it
+    double last_work_ms  = 0.0;
+    
+public:
+    static const int IDLE_TIMEOUT_MS = 250;
+    
+    // Lower trades timing precision for less spinning when many instances share a host
+    double spin_margin_ms = 2.0;
+    
+    FramePacer(double target_fps);
+    
+    // Restarts timing from now; call once SDL_Init has run, since a global
+    // pacer is constructed before it
+    void reset();
+    void detect_vsync(SDL_Window *window);
+    void begin_frame();
+    // Call just before SDL_GL_SwapWindow; with vsync the swap blocks until
+    // the next refresh, which is waiting, not work
+    void end_work();
+    void end_frame(bool idle = false);
+    void report() const;
+    
+    double const get_last_cpu_ms()  const { return last_cpu_ms;  };
+    double const get_last_wall_ms() const { return last_wall_ms; };
+    double const get_last_work_ms() const { return last_work_ms; };
+    double const get_target_ms()    const { return target_seconds * 1000.0; };
+    bool   const is_vsync_paced()   const { return vsync_paced;  };
+};
@@ -0,0 +1,114 @@
+#define GL_SILENCE_DEPRECATION
+#define LOG(argument) std::cout << argument << '\n'
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "MeshRegistry.h"
+
+const int FLOATS_PER_VERTEX = 2;
+
+std::vector<VertexStream> MeshRegistry::streams;
+std::vector<Mesh>         MeshRegistry::meshes;
+size_t                    MeshRegistry::uploaded_bytes = 0;
+
+int MeshRegistry::find_or_add_stream(const float *data, int float_count)
+{
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        const std::vector<float>& existing = streams[i].data;
+        if ((int) existing.size() == float_count && memcmp(existing.data(), data, float_count * sizeof(float)) == 0) return (int) i;
+    }
+    
+    VertexStream stream;
+    stream.data.assign(data, data + float_count);
+    stream.buffer = 0;
+    streams.push_back(stream);
+    return (int) streams.size() - 1;
+}
+
+MeshHandle MeshRegistry::register_mesh(const float *positions, const float *tex_coords, int vertex_count)
+{
+    int float_count      = vertex_count * FLOATS_PER_VERTEX;
+    int position_stream  = find_or_add_stream(positions, float_count);
+    int tex_coord_stream = find_or_add_stream(tex_coords, float_count);
+    
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        if (meshes[i].position_stream == position_stream && meshes[i].tex_coord_stream == tex_coord_stream) return (MeshHandle) i;
+    }
+    
+    Mesh mesh;
+    mesh.position_stream  = position_stream;
+    mesh.tex_coord_stream = tex_coord_stream;
+    mesh.vertex_count     = vertex_count;
+    meshes.push_back(mesh);
+    return (MeshHandle) meshes.size() - 1;
+}
+
+void MeshRegistry::upload(VertexStream& stream)
+{
+    size_t bytes = stream.data.size() * sizeof(float);
+    
+    glGenBuffers(1, &stream.buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+    glBufferData(GL_ARRAY_BUFFER, bytes, stream.data.data(), GL_STATIC_DRAW);
+    uploaded_bytes += bytes;
+}
+
+// No vertex array objects: the games run on legacy 2.1 contexts, where VAOs
+// are an extension, so the two attribute pointers are set per draw instead.
+// That is state, not data; the vertices stay in GPU memory.
+void MeshRegistry::draw(MeshHandle mesh, GLint position_attribute, GLint tex_coord_attribute, const float *tex_coords)
+{
+    const Mesh& entry = meshes[mesh];
+    VertexStream& positions = streams[entry.position_stream];
+    VertexStream& uvs       = streams[entry.tex_coord_stream];
+    
+    if (positions.buffer == 0) upload(positions);
+    glBindBuffer(GL_ARRAY_BUFFER, positions.buffer);
+    glVertexAttribPointer(position_attribute, FLOATS_PER_VERTEX, GL_FLOAT, false, 0, 0);
+    glEnableVertexAttribArray(position_attribute);
+    
+    if (tex_coords != NULL)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glVertexAttribPointer(tex_coord_attribute, FLOATS_PER_VERTEX, GL_FLOAT, false, 0, tex_coords);
+    }
+    else
+    {
+        if (uvs.buffer == 0) upload(uvs);
+        glBindBuffer(GL_ARRAY_BUFFER, uvs.buffer);
+        glVertexAttribPointer(tex_coord_attribute, FLOATS_PER_VERTEX, GL_FLOAT, false, 0, 0);
+    }
+    glEnableVertexAttribArray(tex_coord_attribute);
+    
+    glDrawArrays(GL_TRIANGLES, 0, entry.vertex_count);
+    
+    glDisableVertexAttribArray(position_attribute);
+    glDisableVertexAttribArray(tex_coord_attribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void MeshRegistry::release()
+{
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        if (streams[i].buffer != 0) glDeleteBuffers(1, &streams[i].buffer);
+        streams[i].buffer = 0;
+    }
+    uploaded_bytes = 0;
+}
+
+void MeshRegistry::report()
+{
+    LOG("Meshes: " << meshes.size() << " sharing " << streams.size() << " vertex streams, "
+        << uploaded_bytes << " bytes resident on the GPU");
+}
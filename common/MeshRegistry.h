@@ -0,0 +1,53 @@
+#include <vector>
+
+typedef int MeshHandle;
+
+const MeshHandle INVALID_MESH = -1;
+
+// One attribute's worth of floats, kept on the CPU for backends that do not
+// draw through GL and mirrored into a static vertex buffer for those that do
+struct VertexStream
+{
+    std::vector<float> data;
+    GLuint buffer;
+};
+
+struct Mesh
+{
+    int position_stream;
+    int tex_coord_stream;
+    int vertex_count;
+};
+
+// Holds every static shape the games draw. Each distinct array of positions
+// or texture coordinates is stored once, however many meshes use it, and is
+// uploaded to the GPU the first time it is drawn, so drawing a registered
+// mesh sends no vertex data from client memory. Positions are 2D, texture
+// coordinates are 2D, and both are laid out as GL_TRIANGLES.
+class MeshRegistry
+{
+private:
+    static std::vector<VertexStream> streams;
+    static std::vector<Mesh> meshes;
+    static size_t uploaded_bytes;
+    
+    static int find_or_add_stream(const float *data, int float_count);
+    static void upload(VertexStream& stream);
+    
+public:
+    static MeshHandle register_mesh(const float *positions, const float *tex_coords, int vertex_count);
+    
+    // Binds the mesh's buffers to the given attributes and draws it; passing
+    // tex_coords overrides the stored ones from client memory, for sprites
+    // whose frame changes
+    static void draw(MeshHandle mesh, GLint position_attribute, GLint tex_coord_attribute, const float *tex_coords = NULL);
+    
+    static void release();
+    static void report();
+    
+    static int const get_vertex_count(MeshHandle mesh) { return meshes[mesh].vertex_count; };
+    static const float* get_positions(MeshHandle mesh)  { return streams[meshes[mesh].position_stream].data.data();  };
+    static const float* get_tex_coords(MeshHandle mesh) { return streams[meshes[mesh].tex_coord_stream].data.data(); };
+    static int const get_mesh_count()   { return (int) meshes.size();  };
+    static int const get_stream_count() { return (int) streams.size(); };
+};
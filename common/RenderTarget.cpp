@@ -0,0 +1,137 @@
+#define GL_SILENCE_DEPRECATION
+#define LOG(argument) std::cout << argument << '\n'
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <iostream>
+#include "RenderTarget.h"
+
+RenderTarget::RenderTarget(int width, int height, SDL_Window *window)
+{
+    native_width  = width;
+    native_height = height;
+    
+    // The drawable can be larger than the window on high-DPI displays
+    SDL_GL_GetDrawableSize(window, &window_width, &window_height);
+    
+    int scale_x = window_width  / native_width;
+    int scale_y = window_height / native_height;
+    int scale   = scale_x < scale_y ? scale_x : scale_y;
+    if (scale < 1) scale = 1;
+    
+    output_width  = native_width  * scale;
+    output_height = native_height * scale;
+    output_x = (window_width  - output_width)  / 2;
+    output_y = (window_height - output_height) / 2;
+    
+    // Framebuffer objects are core from 3.0; legacy 2.1 contexts get them,
+    // blit included, from ARB_framebuffer_object
+    supported = SDL_GL_ExtensionSupported("GL_ARB_framebuffer_object") == SDL_TRUE;
+    
+    if (supported)
+    {
+        glGenTextures(1, &colour_texture);
+        glBindTexture(GL_TEXTURE_2D, colour_texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, native_width, native_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colour_texture, 0);
+        supported = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    
+    if (supported)
+    {
+        LOG("Render target: " << native_width << "x" << native_height << " upscaled x" << get_integer_scale()
+            << " to " << output_width << "x" << output_height << " in a " << window_width << "x" << window_height << " window");
+    }
+    else
+    {
+        LOG("Render target: framebuffer objects not supported, drawing at window resolution");
+    }
+}
+
+RenderTarget::~RenderTarget()
+{
+    if (framebuffer != 0) glDeleteFramebuffers(1, &framebuffer);
+    if (colour_texture != 0) glDeleteTextures(1, &colour_texture);
+}
+
+void RenderTarget::begin()
+{
+    if (!supported)
+    {
+        glViewport(0, 0, window_width, window_height);
+        return;
+    }
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, get_width(), get_height());
+}
+
+void RenderTarget::present()
+{
+    if (!supported) return;
+    
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    
+    // Only the bars need clearing, and only when there are bars; the blit
+    // overwrites the rest
+    if (output_width != window_width || output_height != window_height)
+    {
+        GLfloat clear_colour[4];
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clear_colour);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glClearColor(clear_colour[0], clear_colour[1], clear_colour[2], clear_colour[3]);
+    }
+    
+    glBlitFramebuffer(0, 0, get_width(), get_height(),
+                      output_x, output_y, output_x + output_width, output_y + output_height,
+                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    
+    // Leaves the window bound for anything that reads it back, like capture
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, window_width, window_height);
+}
+
+void RenderTarget::update_scale(double frame_ms, double budget_ms)
+{
+    if (!dynamic_resolution || !supported) return;
+    
+    window_ms += frame_ms;
+    if (++window_frames < RENDER_SCALE_WINDOW) return;
+    
+    double average_ms = window_ms / window_frames;
+    window_frames = 0;
+    window_ms     = 0.0;
+    
+    int level = scale_level;
+    if (average_ms > budget_ms * 0.9 && level < RENDER_SCALE_LEVELS - 1) level++;
+    else if (average_ms < budget_ms * 0.6 && level > 0) level--;
+    
+    if (level != scale_level)
+    {
+        scale_level = level;
+        scale_changes++;
+        LOG("Render scale " << RENDER_SCALES[scale_level] << " (" << get_width() << "x" << get_height()
+            << ") after averaging " << average_ms << " ms against a " << budget_ms << " ms budget");
+    }
+}
+
+void RenderTarget::report() const
+{
+    if (!supported) return;
+    LOG("Render target: " << native_width << "x" << native_height << " native, final scale " << RENDER_SCALES[scale_level]
+        << ", " << scale_changes << " resolution changes");
+}
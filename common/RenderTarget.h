@@ -0,0 +1,59 @@
+const int RENDER_SCALE_LEVELS = 3;
+const float RENDER_SCALES[RENDER_SCALE_LEVELS] = {1.0f, 0.75f, 0.5f};
+
+// Frames averaged before dynamic resolution moves one level
+const int RENDER_SCALE_WINDOW = 30;
+
+// Draws the scene into an offscreen framebuffer at the game's native pixel
+// resolution and blits it to the window with GL_NEAREST at the largest whole
+// multiple that fits, letterboxed, so fill and blending cost follow the
+// native size rather than the window. With dynamic resolution on, the scene
+// is drawn into a smaller corner of the same texture when frames run over
+// budget; the blit then stretches by a fractional factor until there is
+// headroom again. Without framebuffer objects it draws straight to the window.
+class RenderTarget
+{
+private:
+    bool supported;
+    GLuint framebuffer = 0;
+    GLuint colour_texture = 0;
+    
+    int native_width;
+    int native_height;
+    int window_width;
+    int window_height;
+    
+    // Letterboxed area of the window the image is blitted to
+    int output_x;
+    int output_y;
+    int output_width;
+    int output_height;
+    
+    int scale_level = 0;
+    int window_frames = 0;
+    double window_ms  = 0.0;
+    int scale_changes = 0;
+    
+public:
+    bool dynamic_resolution = false;
+    
+    RenderTarget(int width, int height, SDL_Window *window);
+    
+    ~RenderTarget();
+    
+    // Binds the framebuffer and its viewport; everything drawn until present
+    // lands in the low-resolution image
+    void begin();
+    void present();
+    
+    // Feed one frame's time against the budget; moves a level down when the
+    // average runs past 90% of it and back up below 60%
+    void update_scale(double frame_ms, double budget_ms);
+    
+    void report() const;
+    
+    int const get_width()  const { return (int) (native_width  * RENDER_SCALES[scale_level]); };
+    int const get_height() const { return (int) (native_height * RENDER_SCALES[scale_level]); };
+    int const get_integer_scale() const { return output_width / native_width; };
+    bool const is_supported() const { return supported; };
+};
@@ -0,0 +1,315 @@
+#define GL_SILENCE_DEPRECATION
+#define STB_IMAGE_IMPLEMENTATION
+#define LOG(argument) std::cout << argument << '\n'
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "stb_image.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "Texture.h"
+
+const int PALETTE_SIZE = 256;
+const GLint TEXTURE_BORDER = 0;
+
+size_t total_texture_bytes = 0;
+size_t total_rgba8_bytes   = 0;
+
+// True when an 8-bit channel value survives a round trip through `bits` bits
+static bool fits_in_bits(unsigned char value, int bits)
+{
+    int reduced  = value >> (8 - bits);
+    int expanded = (reduced << (8 - bits)) | (reduced >> (2 * bits - 8));
+    return expanded == value;
+}
+
+// Collects up to PALETTE_SIZE distinct colours; returns false once there are more
+static bool build_palette(const unsigned char *rgba, int pixel_count, std::vector<unsigned int>& palette, std::vector<unsigned char> *indices)
+{
+    palette.clear();
+    
+    for (int i = 0; i < pixel_count; i++)
+    {
+        unsigned int colour;
+        std::memcpy(&colour, rgba + i * 4, 4);
+        
+        int index = 0;
+        while (index < (int) palette.size() && palette[index] != colour) index++;
+        
+        if (index == (int) palette.size())
+        {
+            if (index == PALETTE_SIZE) return false;
+            palette.push_back(colour);
+        }
+        if (indices != NULL) (*indices)[i] = (unsigned char) index;
+    }
+    return true;
+}
+
+TextureFormat choose_texture_format(const unsigned char *rgba, int width, int height, bool allow_palette)
+{
+    int pixel_count = width * height;
+    
+    bool rgba4444 = true, rgba5551 = true, rgb565 = true;
+    for (int i = 0; i < pixel_count && (rgba4444 || rgba5551 || rgb565); i++)
+    {
+        const unsigned char *pixel = rgba + i * 4;
+        
+        rgba4444 = rgba4444 && fits_in_bits(pixel[0], 4) && fits_in_bits(pixel[1], 4) && fits_in_bits(pixel[2], 4) && fits_in_bits(pixel[3], 4);
+        rgba5551 = rgba5551 && fits_in_bits(pixel[0], 5) && fits_in_bits(pixel[1], 5) && fits_in_bits(pixel[2], 5) && (pixel[3] == 0 || pixel[3] == 255);
+        rgb565   = rgb565   && fits_in_bits(pixel[0], 5) && fits_in_bits(pixel[1], 6) && fits_in_bits(pixel[2], 5) && pixel[3] == 255;
+    }
+    
+    // Only lossless conversions are picked automatically; 16-bit beats a
+    // palette because it needs no extra texture fetch
+    if (rgb565)   return FORMAT_RGB565;
+    if (rgba5551) return FORMAT_RGBA5551;
+    if (rgba4444) return FORMAT_RGBA4444;
+    
+    std::vector<unsigned int> palette;
+    if (allow_palette && build_palette(rgba, pixel_count, palette, NULL)) return FORMAT_PALETTE8;
+    
+    return FORMAT_RGBA8888;
+}
+
+const char* texture_format_name(TextureFormat format)
+{
+    switch (format) {
+        case FORMAT_RGBA4444: return "RGBA4444";
+        case FORMAT_RGBA5551: return "RGB5_A1";
+        case FORMAT_RGB565:   return "RGB565";
+        case FORMAT_PALETTE8: return "PALETTE8";
+        case FORMAT_AUTO:     return "AUTO";
+        default:              return "RGBA8888";
+    }
+}
+
+// 2x2 box filter; odd edges clamp so every level keeps its full footprint
+static void downsample(const unsigned char *source, int width, int height, std::vector<unsigned char>& destination, int& next_width, int& next_height)
+{
+    next_width  = width  > 1 ? width  / 2 : 1;
+    next_height = height > 1 ? height / 2 : 1;
+    destination.resize(next_width * next_height * 4);
+    
+    for (int y = 0; y < next_height; y++)
+    {
+        for (int x = 0; x < next_width; x++)
+        {
+            int x0 = x * 2, x1 = x0 + 1 < width  ? x0 + 1 : x0;
+            int y0 = y * 2, y1 = y0 + 1 < height ? y0 + 1 : y0;
+            
+            for (int channel = 0; channel < 4; channel++)
+            {
+                int sum = source[(y0 * width + x0) * 4 + channel] + source[(y0 * width + x1) * 4 + channel]
+                        + source[(y1 * width + x0) * 4 + channel] + source[(y1 * width + x1) * 4 + channel];
+                destination[(y * next_width + x) * 4 + channel] = (unsigned char) ((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+// Returns the number of texels uploaded; what they cost depends on how the
+// driver chose to store the requested format, see stored_texel_bytes
+static size_t upload_level(const unsigned char *rgba, int width, int height, int level, TextureFormat format)
+{
+    int pixel_count = width * height;
+    
+    if (format == FORMAT_RGBA8888)
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+        return pixel_count;
+    }
+    
+    std::vector<unsigned short> packed(pixel_count);
+    for (int i = 0; i < pixel_count; i++)
+    {
+        const unsigned char *pixel = rgba + i * 4;
+        switch (format) {
+            case FORMAT_RGBA4444:
+                packed[i] = (unsigned short) (((pixel[0] >> 4) << 12) | ((pixel[1] >> 4) << 8) | ((pixel[2] >> 4) << 4) | (pixel[3] >> 4));
+                break;
+            case FORMAT_RGBA5551:
+                packed[i] = (unsigned short) (((pixel[0] >> 3) << 11) | ((pixel[1] >> 3) << 6) | ((pixel[2] >> 3) << 1) | (pixel[3] >= 128 ? 1 : 0));
+                break;
+            default:
+                packed[i] = (unsigned short) (((pixel[0] >> 3) << 11) | ((pixel[1] >> 2) << 5) | (pixel[2] >> 3));
+                break;
+        }
+    }
+    
+    switch (format) {
+        case FORMAT_RGBA4444:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA4, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, packed.data());
+            break;
+        case FORMAT_RGBA5551:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGB5_A1, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, packed.data());
+            break;
+        default:
+            // Desktop GL 2.1 has no sized RGB565 internal format. GL_RGB5 asks
+            // for 5-5-5 and a driver may keep only that, so upload_texture
+            // checks the green bits it actually got
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGB5, width, height, TEXTURE_BORDER, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, packed.data());
+            break;
+    }
+    return pixel_count;
+}
+
+static int component_bits(GLenum component)
+{
+    GLint bits = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, component, &bits);
+    return bits;
+}
+
+// Bytes per texel of the bound texture's level 0 as the driver stored it,
+// which need not be the format that was asked for
+static int stored_texel_bytes()
+{
+    int bits = component_bits(GL_TEXTURE_RED_SIZE) + component_bits(GL_TEXTURE_GREEN_SIZE)
+             + component_bits(GL_TEXTURE_BLUE_SIZE) + component_bits(GL_TEXTURE_ALPHA_SIZE);
+    if (bits <= 16) return 2;
+    return bits <= 24 ? 3 : 4;
+}
+
+static TextureInfo upload_palette_texture(const unsigned char *rgba, int width, int height)
+{
+    TextureInfo info;
+    int pixel_count = width * height;
+    
+    std::vector<unsigned int> palette;
+    std::vector<unsigned char> indices(pixel_count);
+    build_palette(rgba, pixel_count, palette, &indices);
+    palette.resize(PALETTE_SIZE, 0);
+    
+    glGenTextures(1, &info.id);
+    glBindTexture(GL_TEXTURE_2D, info.id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE8, width, height, TEXTURE_BORDER, GL_LUMINANCE, GL_UNSIGNED_BYTE, indices.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // Indices must never be filtered or blended between neighbours
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    
+    glGenTextures(1, &info.palette_id);
+    glBindTexture(GL_TEXTURE_2D, info.palette_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, PALETTE_SIZE, 1, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, palette.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    
+    glBindTexture(GL_TEXTURE_2D, info.id);
+    
+    info.format = FORMAT_PALETTE8;
+    info.bytes  = pixel_count + PALETTE_SIZE * 4;
+    return info;
+}
+
+TextureInfo upload_texture(const unsigned char *rgba, int width, int height, TextureOptions options)
+{
+    TextureFormat format = options.format;
+    if (format == FORMAT_AUTO) format = choose_texture_format(rgba, width, height, options.allow_palette);
+    
+    TextureInfo info;
+    
+    if (format == FORMAT_PALETTE8)
+    {
+        // Averaging indices would blend unrelated palette entries, so there
+        // is no meaningful mip chain to build
+        if (options.mipmaps) LOG("Mipmaps are not built for palette textures; drawing level 0 only.");
+        info = upload_palette_texture(rgba, width, height);
+    }
+    else
+    {
+        glGenTextures(1, &info.id);
+        glBindTexture(GL_TEXTURE_2D, info.id);
+        
+        // Rows of 16-bit texels are not 4-byte aligned for odd widths
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+        size_t texels = upload_level(rgba, width, height, 0, format);
+        
+        // FORMAT_AUTO only picks 565 when it is lossless; if the driver kept
+        // 5-5-5 it is not, so store the image as RGBA8 instead
+        if (format == FORMAT_RGB565 && options.format == FORMAT_AUTO && component_bits(GL_TEXTURE_GREEN_SIZE) < 6)
+        {
+            format = FORMAT_RGBA8888;
+            texels = upload_level(rgba, width, height, 0, format);
+        }
+        
+        int levels = 1;
+        if (options.mipmaps)
+        {
+            std::vector<unsigned char> current(rgba, rgba + width * height * 4), next;
+            int level_width = width, level_height = height;
+            
+            while (level_width > 1 || level_height > 1)
+            {
+                downsample(current.data(), level_width, level_height, next, level_width, level_height);
+                texels += upload_level(next.data(), level_width, level_height, levels, format);
+                current.swap(next);
+                levels++;
+            }
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        info.bytes = texels * stored_texel_bytes();
+        
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, options.mipmaps ? GL_NEAREST_MIPMAP_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        info.format = format;
+    }
+    
+    info.width  = width;
+    info.height = height;
+    
+    // What the old path would have used: a single RGBA8 level
+    info.rgba8_bytes = (size_t) width * height * 4;
+    
+    total_texture_bytes += info.bytes;
+    total_rgba8_bytes   += info.rgba8_bytes;
+    
+    return info;
+}
+
+TextureInfo load_texture_file(const char *filepath, TextureOptions options)
+{
+    int width, height, number_of_components;
+    unsigned char *image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+    if (image == NULL)
+    {
+        LOG("Unable to load image " << filepath << ". Make sure the path is correct.");
+        assert(false);
+        return TextureInfo();
+    }
+    
+    TextureInfo info = upload_texture(image, width, height, options);
+    report_texture(filepath, info);
+    stbi_image_free(image);
+    return info;
+}
+
+// The index texture stays on unit 0 as usual; the palette rides on unit 1
+void bind_palette_texture(GLuint program_id, const TextureInfo& info)
+{
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, info.palette_id);
+    glUniform1i(glGetUniformLocation(program_id, "palette"), 1);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void report_texture(const char *name, const TextureInfo& info)
+{
+    LOG(name << ": " << info.width << "x" << info.height << " " << texture_format_name(info.format)
+        << ", " << info.bytes / 1024.0f << " KB (RGBA8 would be " << info.rgba8_bytes / 1024.0f << " KB)");
+}
+
+void report_texture_memory()
+{
+    LOG("Texture memory: " << total_texture_bytes / 1024.0f << " KB, down from " << total_rgba8_bytes / 1024.0f << " KB as RGBA8");
+}
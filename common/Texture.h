@@ -0,0 +1,34 @@
+enum TextureFormat { FORMAT_AUTO, FORMAT_RGBA8888, FORMAT_RGBA4444, FORMAT_RGBA5551, FORMAT_RGB565, FORMAT_PALETTE8 };
+
+struct TextureOptions
+{
+    TextureFormat format = FORMAT_AUTO;
+    bool mipmaps         = false;
+    // Palette textures need a lookup shader (project_2/shaders/fragment_palette.glsl), so FORMAT_AUTO
+    // only picks them when the caller says it can draw them
+    bool allow_palette   = false;
+};
+
+struct TextureInfo
+{
+    GLuint id         = 0;
+    GLuint palette_id = 0;
+    TextureFormat format = FORMAT_RGBA8888;
+    int width  = 0;
+    int height = 0;
+    size_t bytes       = 0;
+    size_t rgba8_bytes = 0;
+};
+
+TextureFormat choose_texture_format(const unsigned char *rgba, int width, int height, bool allow_palette);
+TextureInfo upload_texture(const unsigned char *rgba, int width, int height, TextureOptions options);
+
+// Decodes an image file to RGBA8 with stb_image, uploads it and reports it;
+// the one image loader all three games share
+TextureInfo load_texture_file(const char *filepath, TextureOptions options = TextureOptions());
+const char* texture_format_name(TextureFormat format);
+
+void bind_palette_texture(GLuint program_id, const TextureInfo& info);
+
+void report_texture(const char *name, const TextureInfo& info);
+void report_texture_memory();
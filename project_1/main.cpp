@@ -1,5 +1,4 @@
 #define GL_SILENCE_DEPRACATION
-#define STB_IMAGE_IMPLEMENTATION
 
 #ifdef _WINDOWS
 #include <GL/glew.h>
@@ -12,7 +11,11 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
-#include "stb_image.h"
+#include "../common/Texture.h"
+#include "../common/FramePacer.h"
+#include "../common/FixedStepLoop.h"
+#include "../common/MeshRegistry.h"
+#include "../common/RenderTarget.h"
 
 #define LOG(statement) std::cout << statement << "\n"
 
@@ -26,20 +29,28 @@ const int VIEWPORT_X = 0;
 const int VIEWPORT_Y = 0;
 const int VIEWPORT_WIDTH = WINDOW_WIDTH;
 const int VIEWPORT_HEIGHT = WINDOW_HEIGHT;
+// The scene is drawn at this size and scaled up by whole pixels to the window
+const int NATIVE_WIDTH = 320;
+const int NATIVE_HEIGHT = 240;
 const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl";
 const char F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
 const char SPRITE1[] = "banana.png";
 const char SPRITE2[] = "banana.png";
 const char SPRITE3[] = "monkey.png";
-float previous_ticks = 0.0f;
+const float FIXED_TIMESTEP = 1.0f / 60.0f;
 float trans_y;
 float rotate_x;
+float previous_trans_y;
+float previous_rotate_x;
 int counter = 0;
 int limit = 100;
 bool jump = true;
 
 SDL_Window* display_window;
 bool game_is_running = true;
+FramePacer pacer(60.0);
+FixedStepLoop step_loop(FIXED_TIMESTEP);
+RenderTarget* render_target;
 ShaderProgram program;
 glm::mat4 view_matrix;
 glm::mat4 projection_matrix;
@@ -51,37 +62,29 @@ GLuint player_texture_id1;
 GLuint player_texture_id2;
 GLuint player_texture_id3;
 
-GLuint load_texture(const char* filepath) {
-    int image_width;
-    int image_height;
-    int number_of_components;
-    unsigned char* image = stbi_load(filepath, &image_width, &image_height, &number_of_components, STBI_rgb_alpha);
-    if(image == NULL){
-        LOG("Unable to load image. Make sure the path is correct.");
-        assert(false);
-    }
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    stbi_image_free(image);
-    return textureID;
-}
+const float QUAD_VERTICES[] = {
+    -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f,
+    -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f
+};
+const float QUAD_TEXTURE_COORDINATES[] = {
+    0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f,
+    0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f
+};
+MeshHandle quad_mesh;
 
 void initialize() {
     SDL_Init(SDL_INIT_VIDEO);
     display_window = SDL_CreateWindow("Simple 2D Scene", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_OPENGL);
     SDL_GLContext context = SDL_GL_CreateContext(display_window);
     SDL_GL_MakeCurrent(display_window, context);
+    pacer.detect_vsync(display_window);
 
 #ifdef _WINDOWS
     glewInit();
 #endif
 
     glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    render_target = new RenderTarget(NATIVE_WIDTH, NATIVE_HEIGHT, display_window);
     program.Load(V_SHADER_PATH, F_SHADER_PATH);
     view_matrix = glm::mat4(1.0f);
     model_banana1 = glm::mat4(1.0f);
@@ -90,15 +93,21 @@ void initialize() {
     projection_matrix = glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f);
     trans_y = 0.0f;
     rotate_x = 0.0f;
+    previous_trans_y = trans_y;
+    previous_rotate_x = rotate_x;
     program.SetViewMatrix(view_matrix);
     program.SetProjectionMatrix(projection_matrix);
-    player_texture_id1 = load_texture(SPRITE1);
-    player_texture_id2 = load_texture(SPRITE2);
-    player_texture_id3 = load_texture(SPRITE3);
+    player_texture_id1 = load_texture_file(SPRITE1).id;
+    player_texture_id2 = load_texture_file(SPRITE2).id;
+    player_texture_id3 = load_texture_file(SPRITE3).id;
+    report_texture_memory();
+    quad_mesh = MeshRegistry::register_mesh(QUAD_VERTICES, QUAD_TEXTURE_COORDINATES, 6);
     glUseProgram(program.programID);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glClearColor(BG_RED, BG_GREEN, BG_BLUE, BG_OPACITY);
+    step_loop.reset();
+    pacer.reset();
 }
 
 void process_input() {
@@ -110,24 +119,13 @@ void process_input() {
     }
 }
 
-void update() {
+void step(float delta_time) {
     counter++;
-    model_banana1 = glm::mat4(1.0f);
-    model_banana2 = glm::mat4(1.0f);
-    model_monkey = glm::mat4(1.0f);
-    model_banana1 = glm::translate(model_banana1, glm::vec3(2.0f, 2.0f, 0.0f));
-    model_banana2 = glm::translate(model_banana2, glm::vec3(-2.0f, 2.0f, 0.0f));
-    model_monkey = glm::translate(model_monkey, glm::vec3(0.0f, -4.0f, 0.0f));
-
-
-    float ticks = (float)SDL_GetTicks() / 1000.0f;
-    float delta_time = ticks - previous_ticks;
-    previous_ticks = ticks;
+    previous_rotate_x = rotate_x;
+    previous_trans_y = trans_y;
 
     rotate_x += 90.0f * delta_time;
 
-    model_banana1 = glm::rotate(model_banana1, glm::radians(rotate_x), glm::vec3(0.0f, 0.0f, 1.0f));
-    model_banana2 = glm::rotate(model_banana2, -glm::radians(rotate_x), glm::vec3(0.0f, 0.0f, 1.0f));
     if (counter > limit) {
         jump = !jump;
         counter = 0;
@@ -138,51 +136,69 @@ void update() {
     else {
         trans_y -= 2.0f * delta_time;
     }
-    model_monkey = glm::translate(model_monkey, glm::vec3(0.0f, trans_y, 0.0f));
 }
 
-void draw_object(glm::mat4& object_model_matrix, GLuint& object_texture_id) {
+void update() {
+    int steps = step_loop.begin_frame();
+    for (int i = 0; i < steps; i++) {
+        step(FIXED_TIMESTEP);
+    }
+
+    // Drawn part of the way between the last two steps, so motion stays
+    // smooth at any display rate
+    float alpha = step_loop.get_alpha();
+    float rotation = previous_rotate_x + (rotate_x - previous_rotate_x) * alpha;
+    float translation = previous_trans_y + (trans_y - previous_trans_y) * alpha;
+
+    model_banana1 = glm::mat4(1.0f);
+    model_banana2 = glm::mat4(1.0f);
+    model_monkey = glm::mat4(1.0f);
+    model_banana1 = glm::translate(model_banana1, glm::vec3(2.0f, 2.0f, 0.0f));
+    model_banana2 = glm::translate(model_banana2, glm::vec3(-2.0f, 2.0f, 0.0f));
+    model_monkey = glm::translate(model_monkey, glm::vec3(0.0f, -4.0f, 0.0f));
+
+    model_banana1 = glm::rotate(model_banana1, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+    model_banana2 = glm::rotate(model_banana2, -glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+    model_monkey = glm::translate(model_monkey, glm::vec3(0.0f, translation, 0.0f));
+}
+
+void draw_object(glm::mat4& object_model_matrix, GLuint& object_texture_id, MeshHandle mesh) {
     program.SetModelMatrix(object_model_matrix);
     glBindTexture(GL_TEXTURE_2D, object_texture_id);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    MeshRegistry::draw(mesh, program.positionAttribute, program.texCoordAttribute);
 }
 
 void render() {
+    render_target->begin();
     glClear(GL_COLOR_BUFFER_BIT);
-    float vertices[] = {
-        -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f,
-        -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f
-    };
-    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program.positionAttribute);
-
-    float texture_coordinates[] = {
-        0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f,
-        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f
-    };
-
-    glVertexAttribPointer(program.texCoordAttribute, 2, GL_FLOAT, false, 0, texture_coordinates);
-    glEnableVertexAttribArray(program.texCoordAttribute);
-
-    draw_object(model_banana1, player_texture_id1);
-    draw_object(model_banana2, player_texture_id2);
-    draw_object(model_monkey, player_texture_id3);
-
-    glDisableVertexAttribArray(program.positionAttribute);
-    glDisableVertexAttribArray(program.texCoordAttribute);
+
+    draw_object(model_banana1, player_texture_id1, quad_mesh);
+    draw_object(model_banana2, player_texture_id2, quad_mesh);
+    draw_object(model_monkey, player_texture_id3, quad_mesh);
+
+    render_target->present();
+    pacer.end_work();
     SDL_GL_SwapWindow(display_window);
 }
 
 void shutdown() {
+    pacer.report();
+    step_loop.report();
+    render_target->report();
+    MeshRegistry::report();
+    MeshRegistry::release();
+    delete render_target;
     SDL_Quit();
 }
 
 int main(int argc, char* argv[]) {
     initialize();
     while (game_is_running) {
+        pacer.begin_frame();
         process_input();
         update();
         render();
+        pacer.end_frame();
     }
     shutdown();
     return 0;
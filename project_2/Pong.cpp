@@ -0,0 +1,70 @@
+#include <cstring>
+#include <cmath>
+#include <type_traits>
+#include "glm/mat4x4.hpp"
+#include "Pong.h"
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must stay memcpy-able for rollback");
+static_assert(std::is_trivially_copyable<FrameInput>::value, "FrameInput must stay memcpy-able for rollback");
+
+const float MINIMUM_COLLISION_DISTANCE = 0.5f;
+const float PADDLE_SPEED = 1.5f;
+const float BALL_SPEED = 2.5f;
+const float PADDLE_LIMIT = 3.0f;
+
+void reset_state(GameState& state)
+{
+    std::memset(&state, 0, sizeof(GameState));
+    state.player_one_position = glm::vec3(-4.5f, 0.0f, 0.0f);
+    state.player_two_position = glm::vec3(4.5f, 0.0f, 0.0f);
+    state.ball_position = glm::vec3(0.0f);
+    state.ball_movement = glm::vec3(1.0f, 0.0f, 0.0f);
+}
+
+void save_state(const GameState& state, GameState& snapshot)
+{
+    std::memcpy(&snapshot, &state, sizeof(GameState));
+}
+
+void load_state(GameState& state, const GameState& snapshot)
+{
+    std::memcpy(&state, &snapshot, sizeof(GameState));
+}
+
+bool check_collision(const glm::vec3& position_a, const glm::vec3& position_b) {
+    return sqrt(pow(position_b[0] - position_a[0], 2) + pow(position_b[1] - position_a[1], 2)) < MINIMUM_COLLISION_DISTANCE;
+}
+
+void move_paddle(glm::vec3& position, signed char direction) {
+    if ((direction > 0 && position.y < PADDLE_LIMIT) || (direction < 0 && position.y > -PADDLE_LIMIT)) {
+        position.y += direction * FIXED_TIMESTEP * PADDLE_SPEED;
+    }
+}
+
+void simulate(GameState& state, FrameInput input) {
+    state.frame++;
+    if (state.game_over) return;
+
+    move_paddle(state.player_one_position, input.player_one);
+    move_paddle(state.player_two_position, input.player_two);
+    state.ball_position += state.ball_movement * FIXED_TIMESTEP * BALL_SPEED;
+
+    if (state.ball_position.y > 3.5f || state.ball_position.y < -3.5f) {
+        state.ball_movement.y = -state.ball_movement.y;
+    }
+    if (state.ball_position.x > 5.0f || state.ball_position.x < -5.0f) {
+        state.game_over = true;
+    }
+    if (check_collision(state.player_one_position, state.ball_position)) {
+        state.ball_movement.x = -state.ball_movement.x;
+        if (state.ball_movement.y < 1.0f && state.ball_movement.y > -1.0f) {
+            state.ball_movement.y = 1.0f;
+        }
+    }
+    else if (check_collision(state.player_two_position, state.ball_position)) {
+        state.ball_movement.x = -state.ball_movement.x;
+        if (state.ball_movement.y < 1.0f && state.ball_movement.y > -1.0f) {
+            state.ball_movement.y = -1.0f;
+        }
+    }
+}
@@ -0,0 +1,26 @@
+// Everything that changes during a match lives in this one flat block, so a
+// snapshot is a single memcpy and resimulation from a snapshot is bit-exact.
+struct GameState
+{
+    glm::vec3 player_one_position;
+    glm::vec3 player_two_position;
+    glm::vec3 ball_position;
+    glm::vec3 ball_movement;
+    int frame;
+    bool game_over;
+};
+
+// Paddle directions for a single fixed step, -1, 0 or 1
+struct FrameInput
+{
+    signed char player_one;
+    signed char player_two;
+};
+
+const float FIXED_TIMESTEP = 1.0f / 60.0f;
+
+void reset_state(GameState& state);
+void save_state(const GameState& state, GameState& snapshot);
+void load_state(GameState& state, const GameState& snapshot);
+void simulate(GameState& state, FrameInput input);
+bool check_collision(const glm::vec3& position_a, const glm::vec3& position_b);
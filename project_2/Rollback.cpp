@@ -0,0 +1,115 @@
+#include <chrono>
+#include <cstring>
+#include "glm/mat4x4.hpp"
+#include "Pong.h"
+#include "Rollback.h"
+
+LoopbackPeer::LoopbackPeer(int delay)
+{
+    delay_steps = delay;
+}
+
+void LoopbackPeer::send(int frame, signed char input, int now)
+{
+    int next = (tail + 1) % PEER_QUEUE_SIZE;
+    if (next == head) return;
+    
+    packets[tail].frame      = frame;
+    packets[tail].input      = input;
+    packets[tail].deliver_at = now + delay_steps;
+    tail = next;
+}
+
+bool LoopbackPeer::receive(int now, int& frame, signed char& input)
+{
+    if (head == tail || packets[head].deliver_at > now) return false;
+    
+    frame = packets[head].frame;
+    input = packets[head].input;
+    head = (head + 1) % PEER_QUEUE_SIZE;
+    return true;
+}
+
+RollbackSession::RollbackSession()
+{
+    reset_state(state);
+    std::memset(snapshots, 0, sizeof(snapshots));
+    std::memset(inputs, 0, sizeof(inputs));
+}
+
+bool RollbackSession::advance(signed char local_input)
+{
+    if (!can_advance()) return false;
+    
+    int slot = state.frame % HISTORY_SIZE;
+    inputs[slot].player_one = local_input;
+    if (state.frame > confirmed_remote_frame) inputs[slot].player_two = last_remote_input;
+    
+    save_state(state, snapshots[slot]);
+    simulate(state, inputs[slot]);
+    return true;
+}
+
+void RollbackSession::add_remote_input(int frame, signed char remote_input)
+{
+    if (frame <= confirmed_remote_frame) return;
+    
+    confirmed_remote_frame = frame;
+    last_remote_input = remote_input;
+    
+    int slot = frame % HISTORY_SIZE;
+    bool mispredicted = frame < state.frame && inputs[slot].player_two != remote_input;
+    inputs[slot].player_two = remote_input;
+    
+    if (mispredicted) rollback(frame);
+}
+
+void RollbackSession::rollback(int from_frame)
+{
+    auto start = std::chrono::steady_clock::now();
+    
+    int target_frame = state.frame;
+    load_state(state, snapshots[from_frame % HISTORY_SIZE]);
+    
+    while (state.frame < target_frame)
+    {
+        int slot = state.frame % HISTORY_SIZE;
+        if (state.frame > confirmed_remote_frame) inputs[slot].player_two = last_remote_input;
+        
+        save_state(state, snapshots[slot]);
+        simulate(state, inputs[slot]);
+    }
+    
+    auto end = std::chrono::steady_clock::now();
+    
+    rollback_count++;
+    last_rollback_frames = target_frame - from_frame;
+    last_rollback_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    if (last_rollback_ms > worst_rollback_ms) worst_rollback_ms = last_rollback_ms;
+}
+
+// Forces a rollback of the given depth and checks that the corrected state is
+// bit-identical to simulating the true inputs straight through.
+bool check_rollback(int frames, double& elapsed_ms)
+{
+    if (frames > MAX_ROLLBACK_FRAMES) frames = MAX_ROLLBACK_FRAMES;
+    
+    RollbackSession session;
+    GameState expected;
+    reset_state(expected);
+    
+    for (int i = 0; i < frames; i++)
+    {
+        session.advance(1);
+        
+        FrameInput input;
+        input.player_one = 1;
+        input.player_two = -1;
+        simulate(expected, input);
+    }
+    
+    for (int i = 0; i < frames; i++) session.add_remote_input(i, -1);
+    
+    elapsed_ms = session.get_worst_rollback_ms();
+    return std::memcmp(&session.get_state(), &expected, sizeof(GameState)) == 0;
+}
@@ -0,0 +1,65 @@
+const int MAX_ROLLBACK_FRAMES = 8;
+const int HISTORY_SIZE = 16;
+const int PEER_QUEUE_SIZE = 64;
+
+// Stands in for a network peer: player two's inputs come back out of it
+// a configurable number of steps after they were sent.
+class LoopbackPeer
+{
+private:
+    struct Packet
+    {
+        int frame;
+        int deliver_at;
+        signed char input;
+    };
+    
+    Packet packets[PEER_QUEUE_SIZE];
+    int head = 0;
+    int tail = 0;
+    
+public:
+    int delay_steps;
+    
+    LoopbackPeer(int delay);
+    
+    void send(int frame, signed char input, int now);
+    bool receive(int now, int& frame, signed char& input);
+};
+
+// Runs ahead on predicted player two input and, when the real input for an
+// earlier frame disagrees, restores that frame's snapshot and resimulates.
+class RollbackSession
+{
+private:
+    GameState state;
+    GameState snapshots[HISTORY_SIZE];
+    FrameInput inputs[HISTORY_SIZE];
+    
+    int confirmed_remote_frame = -1;
+    signed char last_remote_input = 0;
+    
+    int rollback_count = 0;
+    int last_rollback_frames = 0;
+    double last_rollback_ms = 0.0;
+    double worst_rollback_ms = 0.0;
+    
+    void rollback(int from_frame);
+    
+public:
+    RollbackSession();
+    
+    bool can_advance() const { return state.frame - confirmed_remote_frame <= MAX_ROLLBACK_FRAMES; };
+    bool advance(signed char local_input);
+    void add_remote_input(int frame, signed char remote_input);
+    
+    const GameState& get_state() const { return state; };
+    bool const is_confirmed() const { return confirmed_remote_frame >= state.frame - 1; };
+    
+    int    const get_rollback_count()       const { return rollback_count;       };
+    int    const get_last_rollback_frames() const { return last_rollback_frames; };
+    double const get_last_rollback_ms()     const { return last_rollback_ms;     };
+    double const get_worst_rollback_ms()    const { return worst_rollback_ms;    };
+};
+
+bool check_rollback(int frames, double& elapsed_ms);
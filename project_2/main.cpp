@@ -1,5 +1,4 @@
 #define GL_SILENCE_DEPRACATION
-#define STB_IMAGE_IMPLEMENTATION
 
 #ifdef _WINDOWS
 #include <GL/glew.h>
@@ -13,9 +12,16 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
-#include "stb_image.h"
+#include "../common/Texture.h"
+#include "../common/FramePacer.h"
+#include "../common/FixedStepLoop.h"
+#include "../common/MeshRegistry.h"
+#include "../common/RenderTarget.h"
 #include "cmath"
-#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include "Pong.h"
+#include "Rollback.h"
 
 enum Coordinate {
     x_coordinate,
@@ -37,39 +43,62 @@ const int VIEWPORT_Y = 0;
 const int VIEWPORT_WIDTH = WINDOW_WIDTH;
 const int VIEWPORT_HEIGHT = WINDOW_HEIGHT;
 
+// The scene is drawn at this size and scaled up by whole pixels to the window
+const int NATIVE_WIDTH = 320;
+const int NATIVE_HEIGHT = 240;
+
 const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl";
 const char F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
+// Looks each texel's index up in the palette bound to texture unit 1
+const char F_PALETTE_SHADER_PATH[] = "shaders/fragment_palette.glsl";
 
 const char PLAYER_ONE[] = "paddle.png";
 const char PLAYER_TWO[] = "paddle.png";
 const char BALL[] = "ball.png";
 
-const float MINIMUM_COLLISION_DISTANCE = 0.5f;
+const int DEFAULT_PEER_DELAY = 3;
 
 SDL_Window* display_window;
 bool game_is_running = true;
+FramePacer pacer(60.0);
+FixedStepLoop step_loop(FIXED_TIMESTEP);
+RenderTarget* render_target;
 ShaderProgram program;
+ShaderProgram palette_program;
 glm::mat4 view_matrix;
 glm::mat4 projection_matrix;
 glm::mat4 player_one;
 glm::mat4 player_two;
 glm::mat4 ball;
-float previous_ticks = 0.0f;
-
-GLuint player_one_texture_id;
-GLuint player_two_texture_id;
-GLuint ball_texture_id;
+int step_count = 0;
+int logged_rollback_count = 0;
+// The session state before its last advance, blended with the current one when drawing
+GameState previous_state;
+
+TextureInfo player_one_texture;
+TextureInfo player_two_texture;
+TextureInfo ball_texture;
+
+const float PADDLE_VERTICES[] = {
+   -0.1f, -0.5f, 0.1f, -0.5f, 0.1f, 0.5f,
+   -0.1f, -0.5f, -0.1f, 0.5f, 0.1f, 0.5f
+};
+const float BALL_VERTICES[] = {
+    -0.2f, -0.2f, 0.2f, -0.2f, 0.2f, 0.2f,
+    -0.2f, -0.2f, 0.2f, 0.2f, -0.2f, 0.2f
+};
+const float QUAD_TEXTURE_COORDINATES[] = {
+    0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f,
+    0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f
+};
+MeshHandle paddle_mesh;
+MeshHandle ball_mesh;
 
 SDL_Joystick* player_one_controller;
 
-glm::vec3 player_one_position = glm::vec3(-4.5f, 0.0f, 0.0f);
-glm::vec3 player_one_movement = glm::vec3(0.0f, 0.0f, 0.0f);
-
-glm::vec3 player_two_position = glm::vec3(4.5f, 0.0f, 0.0f);
-glm::vec3 player_two_movement = glm::vec3(0.0f, 0.0f, 0.0f);
-
-glm::vec3 ball_position = glm::vec3(0.0f);
-glm::vec3 ball_movement = glm::vec3(1.0f, 0.0f, 0.0f);
+RollbackSession session;
+LoopbackPeer peer(DEFAULT_PEER_DELAY);
+FrameInput frame_input;
 
 float get_screen_to_ortho(float coordinate, Coordinate axis) {
     switch (axis) {
@@ -83,45 +112,22 @@ float get_screen_to_ortho(float coordinate, Coordinate axis) {
     }
 }
 
-GLuint load_texture(const char* filepath) {
-    int image_width;
-    int image_height;
-    int number_of_components;
-    unsigned char* image = stbi_load(filepath, &image_width, &image_height, &number_of_components, STBI_rgb_alpha);
-    if (image == NULL) {
-        LOG("Could not load image file. Please check filepath.");
-        assert(false);
-    }
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    stbi_image_free(image);
-    return textureID;
-}
-
-bool check_collision(glm::vec3& position_a, glm::vec3& position_b) {
-    return sqrt(pow(position_b[0] - position_a[0], 2) + pow(position_b[1] - position_a[1], 2)) < MINIMUM_COLLISION_DISTANCE;
-}
-
 void initialize() {
     SDL_Init(SDL_INIT_VIDEO | SDL_INIT_JOYSTICK);
     player_one_controller = SDL_JoystickOpen(0);
     display_window = SDL_CreateWindow("Pong", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_OPENGL);
     SDL_GLContext context = SDL_GL_CreateContext(display_window);
     SDL_GL_MakeCurrent(display_window, context);
+    pacer.detect_vsync(display_window);
 
 #ifdef _WINDOWS
     glewInit();
 #endif
 
     glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    render_target = new RenderTarget(NATIVE_WIDTH, NATIVE_HEIGHT, display_window);
     program.Load(V_SHADER_PATH, F_SHADER_PATH);
+    palette_program.Load(V_SHADER_PATH, F_PALETTE_SHADER_PATH);
 
     view_matrix = glm::mat4(1.0f);
     player_one = glm::mat4(1.0f);
@@ -131,10 +137,18 @@ void initialize() {
 
     program.SetViewMatrix(view_matrix);
     program.SetProjectionMatrix(projection_matrix);
-
-    player_one_texture_id = load_texture(PLAYER_ONE);
-    player_two_texture_id = load_texture(PLAYER_TWO);
-    ball_texture_id = load_texture(BALL);
+    palette_program.SetViewMatrix(view_matrix);
+    palette_program.SetProjectionMatrix(projection_matrix);
+
+    // The paddle art has three colours, so it can be stored as one index byte per texel
+    TextureOptions paddle_options;
+    paddle_options.allow_palette = true;
+    player_one_texture = load_texture_file(PLAYER_ONE, paddle_options);
+    player_two_texture = load_texture_file(PLAYER_TWO, paddle_options);
+    ball_texture = load_texture_file(BALL);
+    report_texture_memory();
+    paddle_mesh = MeshRegistry::register_mesh(PADDLE_VERTICES, QUAD_TEXTURE_COORDINATES, 6);
+    ball_mesh   = MeshRegistry::register_mesh(BALL_VERTICES, QUAD_TEXTURE_COORDINATES, 6);
 
     glUseProgram(program.programID);
 
@@ -143,11 +157,19 @@ void initialize() {
 
     glClearColor(BG_RED, BG_GREEN, BG_BLUE, BG_OPACITY);
 
+    double rollback_ms;
+    bool deterministic = check_rollback(MAX_ROLLBACK_FRAMES, rollback_ms);
+    LOG("Rollback of " << MAX_ROLLBACK_FRAMES << " frames: " << rollback_ms << " ms (budget " << FIXED_TIMESTEP * 1000.0f << " ms), "
+        << (deterministic ? "deterministic" : "DESYNC"));
+
+    previous_state = session.get_state();
+    step_loop.reset();
+    pacer.reset();
 }
 
 void process_input() {
-    player_one_movement = glm::vec3(0.0f);
-    player_two_movement = glm::vec3(0.0f);
+    frame_input.player_one = 0;
+    frame_input.player_two = 0;
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         switch (event.type) {
@@ -159,24 +181,16 @@ void process_input() {
         case SDL_KEYDOWN:
             switch (event.key.keysym.sym) {
             case SDLK_UP:
-                if (player_two_position.y < 3.0f) {
-                    player_two_movement.y = 1.0f;
-                }
+                frame_input.player_two = 1;
                 break;
             case SDLK_DOWN:
-                if (player_two_position.y > -3.0f) {
-                    player_two_movement.y = -1.0f;
-                }
+                frame_input.player_two = -1;
                 break;
             case SDLK_w:
-                if (player_one_position.y < 3.0f) {
-                    player_one_movement.y = 1.0f;
-                }
+                frame_input.player_one = 1;
                 break;
             case SDLK_s:
-                if (player_one_position.y > -3.0f) {
-                    player_one_movement.y = -1.0f;
-                }
+                frame_input.player_one = -1;
                 break;
             case SDLK_q:
                 game_is_running = false;
@@ -191,115 +205,114 @@ void process_input() {
 
     const Uint8* key_states = SDL_GetKeyboardState(NULL);
     if (key_states[SDL_SCANCODE_UP]) {
-        if (player_two_position.y < 3.0f) {
-            player_two_movement.y = 1.0f;
-        }
+        frame_input.player_two = 1;
     }
     else if (key_states[SDL_SCANCODE_DOWN]) {
-        if (player_two_position.y > -3.0f) {
-            player_two_movement.y = -1.0f;
-        }
+        frame_input.player_two = -1;
     }
     if (key_states[SDL_SCANCODE_W]) {
-        if (player_one_position.y < 3.0f) {
-            player_one_movement.y = 1.0f;
-        }
+        frame_input.player_one = 1;
     }
     else if (key_states[SDL_SCANCODE_S]) {
-        if (player_one_position.y > -3.0f) {
-            player_one_movement.y = -1.0f;
-        }
+        frame_input.player_one = -1;
     }
 }
 
 void update() {
-    player_one = glm::mat4(1.0f);
-    player_two = glm::mat4(1.0f);
-    ball = glm::mat4(1.0f);
-    float ticks = (float)SDL_GetTicks() / 1000.0f;
-    float delta_time = ticks - previous_ticks;
-    previous_ticks = ticks;
-    player_one_position += player_one_movement * delta_time * 1.5f;
-    player_two_position += player_two_movement * delta_time * 1.5f;
-    ball_position += ball_movement * delta_time * 2.5f;
-    player_one = glm::translate(player_one, player_one_position);
-    player_two = glm::translate(player_two, player_two_position);
-    ball = glm::translate(ball, ball_position);
-    if (ball_position.y > 3.5f || ball_position.y < -3.5f) {
-        ball_movement.y = -ball_movement.y;
-    }
-    if (ball_position.x > 5.0f || ball_position.x < -5.0f) {
-        game_is_running = false;
-    }
-    if (check_collision(player_one_position, ball_position)) {
-        ball_movement.x = -ball_movement.x;
-        if (ball_movement.y < 1.0f && ball_movement.y > -1.0f) {
-            ball_movement.y = 1.0f;
+    int steps = step_loop.begin_frame();
+
+    // Player two is routed through the loopback peer, so their input reaches
+    // the session late and gets predicted, then corrected by rollback
+    for (int i = 0; i < steps; i++) {
+        int frame;
+        signed char remote_input;
+        while (peer.receive(step_count, frame, remote_input)) {
+            session.add_remote_input(frame, remote_input);
         }
-    }
-    else if (check_collision(player_two_position, ball_position)) {
-        ball_movement.x = -ball_movement.x;
-        if (ball_movement.y < 1.0f && ball_movement.y > -1.0f) {
-            ball_movement.y = -1.0f;
+
+        if (session.can_advance()) {
+            peer.send(session.get_state().frame, frame_input.player_two, step_count);
+            previous_state = session.get_state();
+            session.advance(frame_input.player_one);
+        }
+        else {
+            // Stalled waiting on the peer: hold still instead of blending
+            // towards a state the session never moved to
+            previous_state = session.get_state();
         }
+
+        step_count++;
+    }
+
+    // Only a rollback that happened this frame; last_rollback_ms keeps its value until the next one
+    if (session.get_rollback_count() != logged_rollback_count && session.get_last_rollback_ms() > FIXED_TIMESTEP * 1000.0f) {
+        LOG("Rollback of " << session.get_last_rollback_frames() << " frames took " << session.get_last_rollback_ms() << " ms");
+    }
+    logged_rollback_count = session.get_rollback_count();
+
+    const GameState& state = session.get_state();
+    if (state.game_over && session.is_confirmed()) {
+        game_is_running = false;
     }
+
+    // A rollback can rewrite the current state under previous_state; the
+    // blend then eases into the corrected position instead of snapping
+    float alpha = step_loop.get_alpha();
+    player_one = glm::translate(glm::mat4(1.0f), previous_state.player_one_position + (state.player_one_position - previous_state.player_one_position) * alpha);
+    player_two = glm::translate(glm::mat4(1.0f), previous_state.player_two_position + (state.player_two_position - previous_state.player_two_position) * alpha);
+    ball = glm::translate(glm::mat4(1.0f), previous_state.ball_position + (state.ball_position - previous_state.ball_position) * alpha);
 }
 
-void draw_object(glm::mat4& object_model_matrix, GLuint& object_texture_id) {
-    program.SetModelMatrix(object_model_matrix);
-    glBindTexture(GL_TEXTURE_2D, object_texture_id);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+void draw_object(glm::mat4& object_model_matrix, const TextureInfo& object_texture, MeshHandle mesh) {
+    ShaderProgram& shader = object_texture.format == FORMAT_PALETTE8 ? palette_program : program;
+    glUseProgram(shader.programID);
+    if (object_texture.format == FORMAT_PALETTE8) {
+        bind_palette_texture(shader.programID, object_texture);
+    }
+    shader.SetModelMatrix(object_model_matrix);
+    glBindTexture(GL_TEXTURE_2D, object_texture.id);
+    MeshRegistry::draw(mesh, shader.positionAttribute, shader.texCoordAttribute);
 }
 
 void render() {
+    render_target->begin();
     glClear(GL_COLOR_BUFFER_BIT);
-    float vertices[] = {
-       -0.1f, -0.5f, 0.1f, -0.5f, 0.1f, 0.5f,
-       -0.1f, -0.5f, -0.1f, 0.5f, 0.1f, 0.5f
-    };
-
-    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program.positionAttribute);
-
-    float texture_coordinates[] = {
-        0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f,
-        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f
-    };
-
-    glVertexAttribPointer(program.texCoordAttribute, 2, GL_FLOAT, false, 0, texture_coordinates);
-    glEnableVertexAttribArray(program.texCoordAttribute);
-
-    draw_object(player_one, player_one_texture_id);
-    draw_object(player_two, player_two_texture_id);
 
-    float vertices2[] = {
-        -0.2f, -0.2f, 0.2f, -0.2f, 0.2f, 0.2f,
-        -0.2f, -0.2f, 0.2f, 0.2f, -0.2f, 0.2f
-    };
-
-    glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, vertices2);
-    glEnableVertexAttribArray(program.positionAttribute);
-   
-
-    draw_object(ball, ball_texture_id);
-
-    glDisableVertexAttribArray(program.positionAttribute);
-    glDisableVertexAttribArray(program.texCoordAttribute);
+    draw_object(player_one, player_one_texture, paddle_mesh);
+    draw_object(player_two, player_two_texture, paddle_mesh);
+    draw_object(ball, ball_texture, ball_mesh);
 
+    render_target->present();
+    pacer.end_work();
     SDL_GL_SwapWindow(display_window);
 }
 
 void shutdown() {
+    LOG("Rollbacks: " << session.get_rollback_count() << ", worst " << session.get_worst_rollback_ms() << " ms");
+    pacer.report();
+    step_loop.report();
+    render_target->report();
+    MeshRegistry::report();
+    MeshRegistry::release();
+    delete render_target;
     SDL_JoystickClose(player_one_controller);
     SDL_Quit();
 }
 
 int main(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--delay") == 0) {
+            peer.delay_steps = atoi(argv[i + 1]);
+        }
+    }
+
     initialize();
     while (game_is_running) {
+        pacer.begin_frame();
         process_input();
         update();
         render();
+        pacer.end_frame();
     }
     shutdown();
     return 0;
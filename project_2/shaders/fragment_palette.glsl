@@ -0,0 +1,11 @@
+// Drop-in replacement for fragment_textured.glsl when drawing FORMAT_PALETTE8
+// textures: diffuse holds 8-bit indices, palette is a 256x1 RGBA lookup.
+uniform sampler2D diffuse;
+uniform sampler2D palette;
+
+varying vec2 texCoordVar;
+
+void main() {
+    float index = texture2D(diffuse, texCoordVar).r;
+    gl_FragColor = texture2D(palette, vec2((index * 255.0 + 0.5) / 256.0, 0.5));
+}
@@ -0,0 +1,183 @@
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#ifdef _WINDOWS
+#include <malloc.h>
+#endif
+#include "AllocationTracker.h"
+
+AllocationSite AllocationTracker::sites[AllocationTracker::MAX_SITES];
+int AllocationTracker::site_count = 0;
+
+long long AllocationTracker::frame_number      = 0;
+long long AllocationTracker::frame_allocations = 0;
+long long AllocationTracker::frame_bytes       = 0;
+bool      AllocationTracker::allow_frame       = false;
+
+thread_local const char *AllocationTracker::current_site = NULL;
+
+// Only the main thread's allocations count towards a frame; audio and
+// driver threads allocate on their own schedule.
+static thread_local bool is_main_thread = false;
+static std::atomic<long long> total_allocations(0);
+
+void AllocationTracker::record(size_t size)
+{
+    total_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (!is_main_thread) return;
+    
+    frame_allocations++;
+    frame_bytes += size;
+    
+    const char *name = current_site != NULL ? current_site : "unscoped";
+    
+    // Linear search by pointer: site names are string literals and there are few
+    int index = 0;
+    while (index < site_count && sites[index].name != name) index++;
+    
+    if (index == site_count)
+    {
+        if (site_count == MAX_SITES) return;
+        sites[index].name = name;
+        sites[index].frame_count = 0;
+        sites[index].total_count = 0;
+        sites[index].total_bytes = 0;
+        site_count++;
+    }
+    
+    sites[index].frame_count++;
+    sites[index].total_count++;
+    sites[index].total_bytes += size;
+}
+
+void AllocationTracker::begin_frame()
+{
+    is_main_thread = true;
+    
+    frame_allocations = 0;
+    frame_bytes       = 0;
+    allow_frame       = false;
+    for (int i = 0; i < site_count; i++) sites[i].frame_count = 0;
+}
+
+void AllocationTracker::end_frame()
+{
+    frame_number++;
+
+#ifdef ASSERT_NO_FRAME_ALLOCATIONS
+    if (frame_number > STEADY_STATE_FRAME && !allow_frame && frame_allocations > 0)
+    {
+        LOG("Frame " << frame_number << " allocated " << frame_allocations << " times (" << frame_bytes << " bytes) in steady state.");
+        report();
+        assert(false);
+    }
+#endif
+}
+
+void AllocationTracker::report()
+{
+    LOG("Allocations: " << total_allocations.load() << " total across all threads");
+    for (int i = 0; i < site_count; i++)
+    {
+        LOG("  " << sites[i].name << ": " << sites[i].frame_count << " this frame, "
+            << sites[i].total_count << " total, " << sites[i].total_bytes << " bytes");
+    }
+}
+
+#ifdef TRACK_ALLOCATIONS
+
+void* operator new(size_t size)
+{
+    AllocationTracker::record(size);
+    void *memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == NULL) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    AllocationTracker::record(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *memory) noexcept                         { std::free(memory); }
+void operator delete[](void *memory) noexcept                       { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept                 { std::free(memory); }
+void operator delete[](void *memory, size_t) noexcept               { std::free(memory); }
+void operator delete(void *memory, const std::nothrow_t&) noexcept   { std::free(memory); }
+void operator delete[](void *memory, const std::nothrow_t&) noexcept { std::free(memory); }
+
+// Types aligned past what malloc guarantees use these from C++17 on; without
+// them they would bypass the counters
+#ifdef __cpp_aligned_new
+
+static void* aligned_malloc(size_t size, std::align_val_t alignment)
+{
+    if (size == 0) size = 1;
+#ifdef _WINDOWS
+    return _aligned_malloc(size, (size_t) alignment);
+#else
+    void *memory = NULL;
+    if (posix_memalign(&memory, (size_t) alignment, size) != 0) return NULL;
+    return memory;
+#endif
+}
+
+static void aligned_free(void *memory)
+{
+#ifdef _WINDOWS
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    AllocationTracker::record(size);
+    void *memory = aligned_malloc(size, alignment);
+    if (memory == NULL) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    AllocationTracker::record(size);
+    return aligned_malloc(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, alignment, tag);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept                           { aligned_free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept                         { aligned_free(memory); }
+void operator delete(void *memory, size_t, std::align_val_t) noexcept                   { aligned_free(memory); }
+void operator delete[](void *memory, size_t, std::align_val_t) noexcept                 { aligned_free(memory); }
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t&) noexcept     { aligned_free(memory); }
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t&) noexcept   { aligned_free(memory); }
+
+#endif
+
+#endif
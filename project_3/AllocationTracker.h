@@ -0,0 +1,51 @@
+// Counts heap allocations per frame and per named call site. The global
+// operator new/delete hooks, aligned forms included when the compiler has
+// them, are only compiled in with TRACK_ALLOCATIONS;
+// add ASSERT_NO_FRAME_ALLOCATIONS to fail on any allocation once the game
+// has reached steady state.
+struct AllocationSite
+{
+    const char *name;
+    long long frame_count;
+    long long total_count;
+    long long total_bytes;
+};
+
+class AllocationTracker
+{
+private:
+    static AllocationSite sites[];
+    static int site_count;
+    
+    static long long frame_number;
+    static long long frame_allocations;
+    static long long frame_bytes;
+    static bool allow_frame;
+    
+public:
+    static const int MAX_SITES = 32;
+    static const int STEADY_STATE_FRAME = 120;
+    
+    static thread_local const char *current_site;
+    
+    static void record(size_t size);
+    static void begin_frame();
+    static void end_frame();
+    static void allow_this_frame() { allow_frame = true; };
+    static void report();
+    
+    static long long const get_frame_allocations() { return frame_allocations; };
+    static long long const get_frame_bytes()       { return frame_bytes;       };
+    static long long const get_frame_number()      { return frame_number;      };
+};
+
+// Attributes every allocation made while it is alive to the given name
+class AllocationScope
+{
+private:
+    const char *previous;
+    
+public:
+    AllocationScope(const char *name)  { previous = AllocationTracker::current_site; AllocationTracker::current_site = name; };
+    ~AllocationScope()                 { AllocationTracker::current_site = previous; };
+};
@@ -0,0 +1,87 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+#include <vector>
+#include "../common/MeshRegistry.h"
+#include "Entity.h"
+#include "Animation.h"
+
+int AnimationSystem::add_clip(int columns, int rows, const int *indices, int count, int frames_per_second, bool looping)
+{
+    AnimationClip clip;
+    clip.first_frame       = (int) (uv_table.size() / FLOATS_PER_FRAME);
+    clip.frame_count       = count;
+    clip.seconds_per_frame = 1.0f / frames_per_second;
+    clip.loop              = looping;
+    
+    float width  = 1.0f / columns;
+    float height = 1.0f / rows;
+    
+    for (int i = 0; i < count; i++)
+    {
+        float u_left   = (float) (indices[i] % columns) / columns;
+        float v_top    = (float) (indices[i] / columns) / rows;
+        float u_right  = u_left + width;
+        float v_bottom = v_top + height;
+        
+        uv_table.insert(uv_table.end(), {
+            u_left,  v_bottom,
+            u_right, v_bottom,
+            u_right, v_top,
+            u_left,  v_bottom,
+            u_left,  v_top,
+            u_right, v_top,
+        });
+    }
+    
+    clips.push_back(clip);
+    return (int) clips.size() - 1;
+}
+
+int AnimationSystem::add_sprite(int clip)
+{
+    first_frame.push_back(0);
+    frame_count.push_back(1);
+    current_frame.push_back(0);
+    seconds_per_frame.push_back(1.0f);
+    timer.push_back(0.0f);
+    loop.push_back(1);
+    
+    int sprite = (int) current_frame.size() - 1;
+    play(sprite, clip);
+    return sprite;
+}
+
+void AnimationSystem::play(int sprite, int clip)
+{
+    first_frame[sprite]       = clips[clip].first_frame;
+    frame_count[sprite]       = clips[clip].frame_count;
+    seconds_per_frame[sprite] = clips[clip].seconds_per_frame;
+    loop[sprite]              = clips[clip].loop ? 1 : 0;
+    current_frame[sprite]     = 0;
+    timer[sprite]             = 0.0f;
+}
+
+void AnimationSystem::update(float delta_time)
+{
+    int sprite_count = (int) current_frame.size();
+    
+    for (int i = 0; i < sprite_count; i++)
+    {
+        timer[i] += delta_time;
+        int steps = (int) (timer[i] / seconds_per_frame[i]);
+        timer[i] -= steps * seconds_per_frame[i];
+        
+        int next = current_frame[i] + steps;
+        int last = frame_count[i] - 1;
+        current_frame[i] = loop[i] ? next % frame_count[i] : (next > last ? last : next);
+    }
+}
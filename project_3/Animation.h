@@ -0,0 +1,37 @@
+const int FLOATS_PER_FRAME = 12;
+
+struct AnimationClip
+{
+    int   first_frame;
+    int   frame_count;
+    float seconds_per_frame;
+    bool  loop;
+};
+
+class AnimationSystem
+{
+private:
+    // Every clip's frames laid out back to back, FLOATS_PER_FRAME UVs each,
+    // in the same vertex order as the quads passed to Entity::render
+    std::vector<float> uv_table;
+    std::vector<AnimationClip> clips;
+    
+    // One slot per animated sprite, updated together in update()
+    std::vector<int>   first_frame;
+    std::vector<int>   frame_count;
+    std::vector<int>   current_frame;
+    std::vector<float> seconds_per_frame;
+    std::vector<float> timer;
+    std::vector<unsigned char> loop;
+    
+public:
+    int add_clip(int columns, int rows, const int *indices, int count, int frames_per_second = Entity::SECONDS_PER_FRAME, bool looping = true);
+    int add_sprite(int clip);
+    void play(int sprite, int clip);
+    void update(float delta_time);
+    
+    const float* get_tex_coords(int sprite) const { return &uv_table[(first_frame[sprite] + current_frame[sprite]) * FLOATS_PER_FRAME]; };
+    int const get_frame(int sprite)        const { return current_frame[sprite]; };
+    bool const is_single_frame(int sprite) const { return frame_count[sprite] == 1; };
+    int const get_sprite_count()           const { return (int) current_frame.size(); };
+};
@@ -0,0 +1,94 @@
+#define LOG(argument) std::cout << argument << '\n'
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+#include <cassert>
+#include <iostream>
+#include "../common/MeshRegistry.h"
+#include "Entity.h"
+#include "ContactEvents.h"
+
+// Side and landing contacts with the same pair are kept apart, so a corner
+// hit reports both rather than whichever overlap happened to be deeper
+static bool same_contact(const ContactEvent& contact, Entity *entity, Entity *other, glm::vec3 normal)
+{
+    return contact.entity == entity && contact.other == other
+        && (contact.normal.x != 0.0f) == (normal.x != 0.0f) && (contact.normal.y != 0.0f) == (normal.y != 0.0f);
+}
+
+void ContactQueue::report(Entity *entity, Entity *other, glm::vec3 normal, float penetration)
+{
+    for (int i = 0; i < touching_count; i++)
+    {
+        if (same_contact(touching[i], entity, other, normal))
+        {
+            touching[i].normal      = normal;
+            touching[i].penetration = penetration;
+            return;
+        }
+    }
+    
+    if (touching_count == MAX_CONTACT_PAIRS)
+    {
+        LOG("Contact pair limit reached; raise MAX_CONTACT_PAIRS.");
+        assert(false);
+        return;
+    }
+    
+    ContactEvent& contact = touching[touching_count++];
+    contact.entity      = entity;
+    contact.other       = other;
+    contact.normal      = normal;
+    contact.penetration = penetration;
+}
+
+void ContactQueue::push(const ContactEvent& contact, ContactPhase phase)
+{
+    if (event_count == MAX_CONTACT_EVENTS)
+    {
+        LOG("Contact event queue full; drain it every frame or raise MAX_CONTACT_EVENTS.");
+        assert(false);
+        return;
+    }
+    
+    events[event_count] = contact;
+    events[event_count].phase = phase;
+    event_count++;
+}
+
+void ContactQueue::end_step()
+{
+    for (int i = 0; i < touching_count; i++)
+    {
+        // Where the step left the entity, after both axes were resolved
+        touching[i].position = touching[i].entity->get_position();
+        
+        bool was_touching = false;
+        for (int j = 0; j < previous_count && !was_touching; j++)
+        {
+            was_touching = same_contact(previous[j], touching[i].entity, touching[i].other, touching[i].normal);
+        }
+        push(touching[i], was_touching ? CONTACT_STAY : CONTACT_BEGIN);
+    }
+    
+    for (int j = 0; j < previous_count; j++)
+    {
+        bool still_touching = false;
+        for (int i = 0; i < touching_count && !still_touching; i++)
+        {
+            still_touching = same_contact(touching[i], previous[j].entity, previous[j].other, previous[j].normal);
+        }
+        if (!still_touching) push(previous[j], CONTACT_END);
+    }
+    
+    for (int i = 0; i < touching_count; i++) previous[i] = touching[i];
+    previous_count = touching_count;
+    touching_count = 0;
+}
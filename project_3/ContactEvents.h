@@ -0,0 +1,40 @@
+const int MAX_CONTACT_PAIRS  = 64;
+const int MAX_CONTACT_EVENTS = 1024;
+
+enum ContactPhase { CONTACT_BEGIN, CONTACT_STAY, CONTACT_END };
+
+struct ContactEvent
+{
+    ContactPhase phase;
+    Entity *entity;
+    Entity *other;
+    glm::vec3 normal;   // points from other towards entity; zero for triggers
+    glm::vec3 position; // entity's position at the end of the step
+    float penetration;
+};
+
+// Collects contacts reported during each fixed step, one per entity pair and
+// axis, and turns them into begin/stay/end events by diffing against the previous
+// step. Events pile up across steps until the game drains them, so a
+// contact that lasts a single substep is still seen.
+class ContactQueue
+{
+private:
+    ContactEvent touching[MAX_CONTACT_PAIRS];
+    ContactEvent previous[MAX_CONTACT_PAIRS];
+    int touching_count = 0;
+    int previous_count = 0;
+    
+    ContactEvent events[MAX_CONTACT_EVENTS];
+    int event_count = 0;
+    
+    void push(const ContactEvent& contact, ContactPhase phase);
+    
+public:
+    void report(Entity *entity, Entity *other, glm::vec3 normal, float penetration);
+    void end_step();
+    void clear_events() { event_count = 0; };
+    
+    int const get_event_count() const { return event_count; };
+    const ContactEvent& get_event(int index) const { return events[index]; };
+};
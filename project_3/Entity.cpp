@@ -12,11 +12,15 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
 #include "cmath"
+#include "../common/MeshRegistry.h"
 #include "Entity.h"
+#include "ContactEvents.h"
+#include "RenderBackend.h"
 
 Entity::Entity()
 {
     position     = glm::vec3(0.0f);
+    previous_position = position;
     velocity     = glm::vec3(0.0f);
     acceleration = glm::vec3(0.0f);
     
@@ -24,12 +28,23 @@ Entity::Entity()
     
     speed = 0;
     model_matrix = glm::mat4(1.0f);
+    
+    set_type(PLATFORM);
 }
 
 Entity::~Entity(){};
 
-void Entity::update(float delta_time, Entity *collidable_entities, int collidable_entity_count)
+void Entity::set_type(EntityType new_type)
 {
+    type            = new_type;
+    collision_layer = layer_bit(new_type);
+    collision_mask  = COLLISION_MASKS[new_type];
+    is_trigger      = TRIGGER_TYPES[new_type];
+}
+
+void Entity::update(float delta_time, Entity *collidable_entities, int collidable_entity_count, ContactQueue *contacts)
+{
+    previous_position = position;
     if (!is_active) return;
     collided_top    = false;
     collided_bottom = false;
@@ -40,44 +55,58 @@ void Entity::update(float delta_time, Entity *collidable_entities, int collidabl
     velocity += acceleration * delta_time;
     
     position.y += velocity.y * delta_time;
-    check_collision_y(collidable_entities, collidable_entity_count);
+    check_collision_y(collidable_entities, collidable_entity_count, contacts);
     
     position.x += velocity.x * delta_time;
-    check_collision_x(collidable_entities, collidable_entity_count);
+    check_collision_x(collidable_entities, collidable_entity_count, contacts);
     
     model_matrix = glm::mat4(1.0f);
     model_matrix = glm::translate(model_matrix, position);
 }
 
-void const Entity::check_collision_y(Entity* collidable_entities, int collidable_entity_count)
+void const Entity::check_collision_y(Entity* collidable_entities, int collidable_entity_count, ContactQueue *contacts)
 {
     for (int i = 0; i < collidable_entity_count; i++)
     {
         Entity* collidable_entity = &collidable_entities[i];
         
+        if (!can_collide(collidable_entity)) continue;
+        
+        // Triggers only need reporting once per step, so the x pass skips them
+        if (is_trigger || collidable_entity->is_trigger)
+        {
+            if (contacts != NULL && check_collision(collidable_entity)) contacts->report(this, collidable_entity, glm::vec3(0.0f), 0.0f);
+            continue;
+        }
+        
         if (check_collision(collidable_entity))
         {
             float y_distance = fabs(position.y - collidable_entity->position.y);
             float y_overlap = fabs(y_distance - (height / 2.0f) - (collidable_entity->height / 2.0f));
+            // Only a resolved overlap is a contact; resting in place moves nothing
             if (velocity.y > 0) {
                 position.y   -= y_overlap;
                 velocity.y    = 0;
                 collided_top  = true;
+                if (contacts != NULL) contacts->report(this, collidable_entity, glm::vec3(0.0f, -1.0f, 0.0f), y_overlap);
             } else if (velocity.y < 0) {
                 position.y      += y_overlap;
                 velocity.y       = 0;
                 collided_bottom  = true;
+                if (contacts != NULL) contacts->report(this, collidable_entity, glm::vec3(0.0f, 1.0f, 0.0f), y_overlap);
             }
         }
     }
 }
 
-void const Entity::check_collision_x(Entity* collidable_entities, int collidable_entity_count)
+void const Entity::check_collision_x(Entity* collidable_entities, int collidable_entity_count, ContactQueue *contacts)
 {
     for (int i = 0; i < collidable_entity_count; i++)
     {
         Entity *collidable_entity = &collidable_entities[i];
         
+        if (!can_collide(collidable_entity) || is_trigger || collidable_entity->is_trigger) continue;
+        
         if (check_collision(collidable_entity))
         {
             float x_distance = fabs(position.x - collidable_entity->position.x);
@@ -86,32 +115,26 @@ void const Entity::check_collision_x(Entity* collidable_entities, int collidable
                 position.x     -= x_overlap;
                 velocity.x      = 0;
                 collided_right  = true;
+                if (contacts != NULL) contacts->report(this, collidable_entity, glm::vec3(-1.0f, 0.0f, 0.0f), x_overlap);
             } else if (velocity.x < 0) {
                 position.x    += x_overlap;
                 velocity.x     = 0;
                 collided_left  = true;
+                if (contacts != NULL) contacts->report(this, collidable_entity, glm::vec3(1.0f, 0.0f, 0.0f), x_overlap);
             }
         }
     }
 }
 
-void Entity::render(ShaderProgram *program, float coord[])
+void const Entity::interpolate(float alpha)
 {
-    program->SetModelMatrix(model_matrix);
-    
-    float tex_coords[] = {0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f};
-    
-    glBindTexture(GL_TEXTURE_2D, texture_id);
-    
-    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, coord);
-    glEnableVertexAttribArray(program->positionAttribute);
-    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->texCoordAttribute);
-    
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-    glDisableVertexAttribArray(program->positionAttribute);
-    glDisableVertexAttribArray(program->texCoordAttribute);
+    model_matrix = glm::mat4(1.0f);
+    model_matrix = glm::translate(model_matrix, previous_position + (position - previous_position) * alpha);
+}
+
+void Entity::render(RenderBackend *renderer, MeshHandle mesh, const float *tex_coords)
+{
+    renderer->submit_mesh(texture_id, model_matrix, mesh, tex_coords);
 }
 
 bool const Entity::check_collision(Entity *other) const
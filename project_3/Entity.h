@@ -1,4 +1,22 @@
-enum EntityType { PLATFORM, PLAYER, ITEM };
+enum EntityType { PLATFORM, PLAYER, ITEM, MARKER };
+
+// Each type sits on its own layer bit. Two entities are only tested for
+// overlap when each one's mask contains the other's layer, so rejected pairs
+// cost two ANDs and never reach the geometric test.
+constexpr unsigned int layer_bit(EntityType type) { return 1u << type; }
+
+constexpr unsigned int COLLISION_MASKS[] = {
+    layer_bit(PLAYER),                     // PLATFORM: static, so never against another platform
+    layer_bit(PLATFORM) | layer_bit(ITEM), // PLAYER
+    layer_bit(PLAYER),                     // ITEM
+    0,                                     // MARKER: win/lose text, never collides
+};
+
+// Triggers report contacts but are not solid: nothing is pushed apart
+constexpr bool TRIGGER_TYPES[] = { false, false, true, false };
+
+class ContactQueue;
+class RenderBackend;
 
 class Entity
 {
@@ -6,18 +24,25 @@ private:
     bool is_active = true;
     
     glm::vec3 position;
+    // Where the last update started, for blending between steps at render time
+    glm::vec3 previous_position;
     glm::vec3 velocity;
     glm::vec3 acceleration;
     
     float width  = 1;
     float height = 1;
     
+    EntityType type;
+    
 public:
     static const int SECONDS_PER_FRAME = 4;
     
     GLuint texture_id;
     glm::mat4 model_matrix;
-    EntityType type;
+    
+    unsigned int collision_layer;
+    unsigned int collision_mask;
+    bool is_trigger;
     
     float speed;
     glm::vec3 movement;
@@ -31,12 +56,17 @@ public:
     
     ~Entity();
 
-    void update(float delta_time, Entity *collidable_entities, int collidable_entity_count);
-    void render(ShaderProgram *program, float coord[]);
+    void update(float delta_time, Entity *collidable_entities, int collidable_entity_count, ContactQueue *contacts = NULL);
+    void render(RenderBackend *renderer, MeshHandle mesh, const float *tex_coords = NULL);
     
-    void const check_collision_y(Entity *collidable_entities, int collidable_entity_count);
-    void const check_collision_x(Entity *collidable_entities, int collidable_entity_count);
+    // Points the model matrix alpha of the way from the previous step's
+    // position to the current one; 1 is exactly where update left it
+    void const interpolate(float alpha);
+    
+    void const check_collision_y(Entity *collidable_entities, int collidable_entity_count, ContactQueue *contacts = NULL);
+    void const check_collision_x(Entity *collidable_entities, int collidable_entity_count, ContactQueue *contacts = NULL);
     bool const check_collision(Entity *other) const;
+    bool const can_collide(const Entity *other) const { return (collision_mask & other->collision_layer) && (other->collision_mask & collision_layer); };
     
     void activate()   { is_active = true;  };
     void deactivate() { is_active = false; };
@@ -48,7 +78,8 @@ public:
     int       const get_width()        const { return width;        };
     int       const get_height()       const { return height;       };
     
-    void const set_position(glm::vec3 new_position)         { position = new_position;         };
+    // Also moves the previous position, so a teleport is not blended across
+    void const set_position(glm::vec3 new_position)         { position = new_position; previous_position = new_position; };
     void const set_movement(glm::vec3 new_movement)         { movement = new_movement;         };
     void const set_velocity(glm::vec3 new_velocity)         { velocity = new_velocity;         };
     void const set_acceleration(glm::vec3 new_acceleration) { acceleration = new_acceleration; };
@@ -56,4 +87,8 @@ public:
     void const set_height(float new_height)                 { height = new_height;             };
     
     bool const get_active() const { return is_active;};
+    
+    // Also resets the layer, mask and trigger flag from the tables above
+    void set_type(EntityType new_type);
+    EntityType const get_type() const { return type; };
 };
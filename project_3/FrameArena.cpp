@@ -0,0 +1,51 @@
+#define LOG(argument) std::cout << argument << '\n'
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "FrameArena.h"
+
+FrameArena::FrameArena(size_t size)
+{
+    buffer   = new unsigned char[size];
+    capacity = size;
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+    delete [] buffer;
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+    size_t start = (offset + alignment - 1) & ~(alignment - 1);
+    
+    if (start + size > capacity)
+    {
+        // Slower, but the caller writes through the pointer, so never return NULL
+        if (overflow_bytes == 0) LOG("Frame arena exhausted: " << start + size << " of " << capacity << " bytes requested, spilling to the heap.");
+        
+        unsigned char *block = new unsigned char[size + alignment];
+        overflow.push_back(block);
+        overflow_bytes += size;
+        
+        uintptr_t aligned = ((uintptr_t) block + alignment - 1) & ~(uintptr_t) (alignment - 1);
+        return (void*) aligned;
+    }
+    
+    offset = start + size;
+    if (offset > high_water) high_water = offset;
+    
+    return buffer + start;
+}
+
+void FrameArena::reset()
+{
+    offset = 0;
+    
+    for (size_t i = 0; i < overflow.size(); i++) delete [] overflow[i];
+    overflow.clear();
+    overflow_bytes = 0;
+}
@@ -0,0 +1,36 @@
+// Linear allocator for buffers that only live until the end of the frame.
+// Allocation is a pointer bump; reset() releases everything at once. A
+// request that does not fit spills to the heap, in every build type, and the
+// spill is freed by the same reset().
+class FrameArena
+{
+private:
+    unsigned char *buffer;
+    size_t capacity;
+    size_t offset     = 0;
+    size_t high_water = 0;
+    
+    std::vector<unsigned char*> overflow;
+    size_t overflow_bytes = 0;
+    
+public:
+    FrameArena(size_t size);
+    
+    ~FrameArena();
+    
+    // The buffer is owned; a copy would free it twice
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    
+    void* allocate(size_t size, size_t alignment = 16);
+    void reset();
+    
+    template <typename T>
+    T* allocate_array(size_t count) { return static_cast<T*>(allocate(sizeof(T) * count, alignof(T))); };
+    
+    size_t const get_used()       const { return offset;     };
+    size_t const get_high_water() const { return high_water; };
+    size_t const get_capacity()   const { return capacity;   };
+    // Bytes spilled to the heap since the last reset; nonzero means capacity is too small
+    size_t const get_overflow_bytes() const { return overflow_bytes; };
+};
@@ -0,0 +1,226 @@
+#define GL_SILENCE_DEPRECATION
+#define LOG(argument) std::cout << argument << '\n'
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameCapture.h"
+
+#ifdef CAPTURE_PNG
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#endif
+
+FrameCapture::FrameCapture(int capture_width, int capture_height, const char *output_path, CaptureFormat capture_format)
+{
+    width       = capture_width;
+    height      = capture_height;
+    frame_bytes = (size_t) width * height * 4;
+    format      = capture_format;
+    path        = output_path;
+    
+    glGenBuffers(CAPTURE_RING_SIZE, buffers);
+    for (int i = 0; i < CAPTURE_RING_SIZE; i++)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frame_bytes, NULL, GL_STREAM_READ);
+        pending[i] = false;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    
+    for (int i = 0; i < CAPTURE_QUEUE_SIZE; i++) queue[i].resize(frame_bytes);
+    
+    if (format == CAPTURE_Y4M)
+    {
+        planes.resize((size_t) width * height * 3);
+        stream = fopen(path.c_str(), "wb");
+        if (stream == NULL) LOG("Unable to open " << path << " for capture.");
+        else
+        {
+            fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, CAPTURE_FRAME_RATE);
+            LOG("Capturing " << width << "x" << height << " y4m to " << path << " (ffmpeg -i " << path << " out.mp4)");
+        }
+    }
+    
+    worker = std::thread(&FrameCapture::encode_frames, this);
+}
+
+FrameCapture::~FrameCapture()
+{
+    finish();
+}
+
+void FrameCapture::capture()
+{
+    int buffer = next_buffer;
+    
+    // This buffer was filled CAPTURE_RING_SIZE frames ago; collect it before reuse
+    if (pending[buffer]) collect(buffer);
+    
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[buffer]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    
+    pending[buffer]      = true;
+    issued_frame[buffer] = frame_number++;
+    issued_at[buffer]    = SDL_GetPerformanceCounter();
+    next_buffer = (buffer + 1) % CAPTURE_RING_SIZE;
+}
+
+void FrameCapture::collect(int buffer)
+{
+    pending[buffer] = false;
+    frames_captured++;
+    
+    double latency_ms = (SDL_GetPerformanceCounter() - issued_at[buffer]) * 1000.0 / SDL_GetPerformanceFrequency();
+    total_latency_ms += latency_ms;
+    if (latency_ms > worst_latency_ms) worst_latency_ms = latency_ms;
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    if (queue_count == CAPTURE_QUEUE_SIZE)
+    {
+        // Encoder is behind; dropping here keeps the game from ever waiting on it
+        frames_dropped++;
+        return;
+    }
+    int slot = (queue_head + queue_count) % CAPTURE_QUEUE_SIZE;
+    lock.unlock();
+    
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[buffer]);
+    const unsigned char *pixels = (const unsigned char*) glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (pixels != NULL)
+    {
+        std::memcpy(queue[slot].data(), pixels, frame_bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (pixels == NULL)
+    {
+        frames_dropped++;
+        return;
+    }
+    
+    lock.lock();
+    queue_frame[slot] = issued_frame[buffer];
+    queue_count++;
+    lock.unlock();
+    frame_ready.notify_one();
+}
+
+void FrameCapture::encode_frames()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    while (true)
+    {
+        frame_ready.wait(lock, [this]() { return queue_count > 0 || stopping; });
+        if (queue_count == 0 && stopping) break;
+        
+        int slot = queue_head;
+        lock.unlock();
+        
+        // Only the encoder touches this slot until queue_head moves past it
+        write_frame(queue[slot].data(), queue_frame[slot]);
+        
+        lock.lock();
+        queue_head = (queue_head + 1) % CAPTURE_QUEUE_SIZE;
+        queue_count--;
+        frames_encoded++;
+    }
+}
+
+void FrameCapture::write_frame(const unsigned char *pixels, int number)
+{
+    size_t row_bytes = (size_t) width * 4;
+    
+    if (format == CAPTURE_Y4M)
+    {
+        if (stream == NULL) return;
+        
+        size_t plane_bytes = (size_t) width * height;
+        unsigned char *luma = planes.data();
+        unsigned char *blue = luma + plane_bytes;
+        unsigned char *red  = blue + plane_bytes;
+        
+        // GL rows run bottom-up; video frames are top-down. Studio-range
+        // BT.601 in 8-bit fixed point, which is what y4m players assume
+        for (int y = 0; y < height; y++)
+        {
+            const unsigned char *row = pixels + (height - 1 - y) * row_bytes;
+            for (int x = 0; x < width; x++)
+            {
+                int r = row[x * 4], g = row[x * 4 + 1], b = row[x * 4 + 2];
+                size_t i = (size_t) y * width + x;
+                luma[i] = (unsigned char) (((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                blue[i] = (unsigned char) (((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                red[i]  = (unsigned char) (((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+            }
+        }
+        
+        fputs("FRAME\n", stream);
+        fwrite(planes.data(), 1, planes.size(), stream);
+        return;
+    }
+    
+    char filename[512];
+#ifdef CAPTURE_PNG
+    snprintf(filename, sizeof(filename), "%s_%05d.png", path.c_str(), number);
+    stbi_flip_vertically_on_write(1);
+    stbi_write_png(filename, width, height, 4, pixels, (int) row_bytes);
+#else
+    snprintf(filename, sizeof(filename), "%s_%05d.ppm", path.c_str(), number);
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) return;
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    for (int y = height - 1; y >= 0; y--)
+    {
+        for (int x = 0; x < width; x++) fwrite(pixels + y * row_bytes + x * 4, 1, 3, file);
+    }
+    fclose(file);
+#endif
+}
+
+void FrameCapture::finish()
+{
+    if (!worker.joinable()) return;
+    
+    // Drain the ring in issue order so the stream stays in sequence
+    for (int i = 0; i < CAPTURE_RING_SIZE; i++)
+    {
+        int buffer = (next_buffer + i) % CAPTURE_RING_SIZE;
+        if (pending[buffer]) collect(buffer);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    frame_ready.notify_one();
+    worker.join();
+    
+    glDeleteBuffers(CAPTURE_RING_SIZE, buffers);
+    if (stream != NULL) fclose(stream);
+    stream = NULL;
+    
+    report();
+}
+
+void FrameCapture::report() const
+{
+    LOG("Capture: " << frames_captured << " frames read back, " << frames_encoded << " encoded, " << frames_dropped << " dropped, "
+        << "readback latency " << (frames_captured > 0 ? total_latency_ms / frames_captured : 0.0) << " ms mean / "
+        << worst_latency_ms << " ms worst (" << CAPTURE_RING_SIZE << " frames deep)");
+}
@@ -0,0 +1,73 @@
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int CAPTURE_RING_SIZE  = 3;
+const int CAPTURE_QUEUE_SIZE = 8;
+const int CAPTURE_FRAME_RATE = 60;
+
+// CAPTURE_Y4M writes one YUV4MPEG2 stream (4:4:4, BT.601), which ffmpeg and
+// mpv read with no extra flags: ffmpeg -i capture.y4m out.mp4
+// CAPTURE_IMAGES writes numbered PPMs; building with -DCAPTURE_PNG writes
+// PNGs instead, which needs stb_image_write.h next to this file.
+enum CaptureFormat { CAPTURE_Y4M, CAPTURE_IMAGES };
+
+// Reads frames back through a ring of pixel buffer objects: each frame's
+// glReadPixels only queues a copy, and the buffer is mapped CAPTURE_RING_SIZE
+// frames later when the GPU is long done with it. Encoding and disk writes
+// happen on a worker thread.
+class FrameCapture
+{
+private:
+    int width;
+    int height;
+    size_t frame_bytes;
+    CaptureFormat format;
+    std::string path;
+    
+    GLuint buffers[CAPTURE_RING_SIZE];
+    bool   pending[CAPTURE_RING_SIZE];
+    int    issued_frame[CAPTURE_RING_SIZE];
+    Uint64 issued_at[CAPTURE_RING_SIZE];
+    int    next_buffer = 0;
+    int    frame_number = 0;
+    
+    // Preallocated hand-off slots between the render thread and the encoder
+    std::vector<unsigned char> queue[CAPTURE_QUEUE_SIZE];
+    int queue_frame[CAPTURE_QUEUE_SIZE];
+    int queue_head  = 0;
+    int queue_count = 0;
+    bool stopping   = false;
+    
+    std::mutex mutex;
+    std::condition_variable frame_ready;
+    std::thread worker;
+    FILE *stream = NULL;
+    
+    // Y, Cb and Cr planes of the frame being written; only the worker uses it
+    std::vector<unsigned char> planes;
+    
+    int    frames_captured = 0;
+    int    frames_dropped  = 0;
+    int    frames_encoded  = 0;
+    double total_latency_ms = 0.0;
+    double worst_latency_ms = 0.0;
+    
+    void collect(int buffer);
+    void encode_frames();
+    void write_frame(const unsigned char *pixels, int number);
+    
+public:
+    FrameCapture(int capture_width, int capture_height, const char *output_path, CaptureFormat capture_format = CAPTURE_Y4M);
+    
+    ~FrameCapture();
+    
+    void capture();
+    void finish();
+    void report() const;
+    
+    int const get_frames_dropped() const { return frames_dropped; };
+};
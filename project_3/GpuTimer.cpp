@@ -0,0 +1,173 @@
+#define GL_SILENCE_DEPRECATION
+#define LOG(argument) std::cout << argument << '\n'
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <cstring>
+#include <iostream>
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer()
+{
+    // GL_TIME_ELAPSED needs GL 3.3 or ARB_timer_query, which Mesa's llvmpipe
+    // has; some drivers expose the entry points but report a zero-bit counter
+    GLint counter_bits = 0;
+    supported = SDL_GL_ExtensionSupported("GL_ARB_timer_query") == SDL_TRUE;
+    if (supported)
+    {
+        glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &counter_bits);
+        supported = counter_bits > 0;
+    }
+    
+    for (int slot = 0; slot < GPU_TIMER_LATENCY; slot++) scope_count[slot] = 0;
+    if (supported) glGenQueries(GPU_TIMER_LATENCY * GPU_TIMER_MAX_SCOPES, &queries[0][0]);
+    
+    LOG("GPU timer queries: " << (supported ? "enabled" : "not supported, GPU times will not be reported"));
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (supported) glDeleteQueries(GPU_TIMER_LATENCY * GPU_TIMER_MAX_SCOPES, &queries[0][0]);
+}
+
+int GpuTimer::find_stat(const char *name)
+{
+    for (int i = 0; i < stat_count; i++)
+    {
+        if (stats[i].name == name || strcmp(stats[i].name, name) == 0) return i;
+    }
+    if (stat_count == GPU_TIMER_MAX_NAMES) return -1;
+    
+    GpuScopeStats& stat = stats[stat_count];
+    stat.name     = name;
+    stat.last_ms  = 0.0;
+    stat.total_ms = 0.0;
+    stat.worst_ms = 0.0;
+    stat.samples  = 0;
+    return stat_count++;
+}
+
+void GpuTimer::collect(int slot)
+{
+    int count = scope_count[slot];
+    if (count == 0) return;
+    
+    // Queries complete in the order they were issued, so if the last one is
+    // ready all of them are
+    GLint available = 0;
+    glGetQueryObjectiv(queries[slot][count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+    {
+        frames_dropped++;
+        return;
+    }
+    
+    // A pass that did not run this frame reads as zero rather than stale
+    for (int i = 0; i < stat_count; i++) stats[i].last_ms = 0.0;
+    
+    last_frame_ms = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        GLuint64 elapsed;
+        glGetQueryObjectui64v(queries[slot][i], GL_QUERY_RESULT, &elapsed);
+        
+        double elapsed_ms = elapsed / 1000000.0;
+        last_frame_ms += elapsed_ms;
+        
+        int stat_index = scope_stat[slot][i];
+        if (stat_index < 0) continue;
+        
+        // The same name can be opened more than once in a frame
+        GpuScopeStats& stat = stats[stat_index];
+        stat.last_ms  += elapsed_ms;
+        stat.total_ms += elapsed_ms;
+        stat.samples++;
+        if (elapsed_ms > stat.worst_ms) stat.worst_ms = elapsed_ms;
+    }
+    total_frame_ms += last_frame_ms;
+    frames_timed++;
+}
+
+void GpuTimer::begin_frame()
+{
+    if (!supported) return;
+    
+    // Balance anything left open so the slot's queries are all ended
+    while (open_depth > 0) end_scope();
+    
+    frame_slot = (frame_slot + 1) % GPU_TIMER_LATENCY;
+    collect(frame_slot);
+    scope_count[frame_slot] = 0;
+}
+
+void GpuTimer::begin_scope(const char *name)
+{
+    if (!supported) return;
+    
+    if (open_depth++ > 0)
+    {
+        if (!warned_nesting)
+        {
+            LOG("GPU timer: scope \"" << name << "\" opened inside another; it is counted in the outer one");
+            warned_nesting = true;
+        }
+        return;
+    }
+    
+    int scope = scope_count[frame_slot];
+    open_timed = scope < GPU_TIMER_MAX_SCOPES;
+    if (!open_timed) return;
+    
+    scope_stat[frame_slot][scope] = find_stat(name);
+    glBeginQuery(GL_TIME_ELAPSED, queries[frame_slot][scope]);
+    scope_count[frame_slot]++;
+}
+
+void GpuTimer::end_scope()
+{
+    if (!supported || open_depth == 0) return;
+    if (--open_depth > 0 || !open_timed) return;
+    
+    glEndQuery(GL_TIME_ELAPSED);
+    open_timed = false;
+}
+
+double GpuTimer::get_last_ms(const char *name) const
+{
+    for (int i = 0; i < stat_count; i++)
+    {
+        if (stats[i].name == name || strcmp(stats[i].name, name) == 0) return stats[i].last_ms;
+    }
+    return 0.0;
+}
+
+void GpuTimer::log_frame(double cpu_ms) const
+{
+    if (!supported || frames_timed == 0) return;
+    
+    std::cout << "CPU " << cpu_ms << " ms, GPU " << last_frame_ms << " ms (";
+    for (int i = 0; i < stat_count; i++)
+    {
+        std::cout << (i > 0 ? ", " : "") << stats[i].name << " " << stats[i].last_ms;
+    }
+    std::cout << ") " << (last_frame_ms > cpu_ms ? "GPU-bound" : "CPU-bound") << '\n';
+}
+
+void GpuTimer::report() const
+{
+    if (!supported || frames_timed == 0) return;
+    
+    LOG("GPU frames timed: " << frames_timed << " (" << frames_dropped << " not ready in time), "
+        << total_frame_ms / frames_timed << " ms per frame");
+    for (int i = 0; i < stat_count; i++)
+    {
+        const GpuScopeStats& stat = stats[i];
+        if (stat.samples == 0) continue;
+        LOG("  " << stat.name << ": " << stat.total_ms / stat.samples << " ms average, " << stat.worst_ms << " ms worst");
+    }
+}
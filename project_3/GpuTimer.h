@@ -0,0 +1,74 @@
+const int GPU_TIMER_LATENCY    = 4;
+const int GPU_TIMER_MAX_SCOPES = 16;
+const int GPU_TIMER_MAX_NAMES  = 8;
+
+struct GpuScopeStats
+{
+    const char *name;
+    double last_ms;
+    double total_ms;
+    double worst_ms;
+    int samples;
+};
+
+// Times render passes on the GPU with one GL_TIME_ELAPSED query per scope,
+// which counts only the GPU time spent on that pass's commands, not the idle
+// gaps between passes that timestamp differences would include. Elapsed
+// queries cannot nest, so a scope opened inside another is folded into the
+// outer one. Results are read GPU_TIMER_LATENCY frames later, by which point
+// they are ready and reading them never stalls the pipeline; the frame's GPU
+// time is the sum of its passes.
+class GpuTimer
+{
+private:
+    bool supported;
+    
+    GLuint queries[GPU_TIMER_LATENCY][GPU_TIMER_MAX_SCOPES];
+    int scope_stat[GPU_TIMER_LATENCY][GPU_TIMER_MAX_SCOPES];
+    int scope_count[GPU_TIMER_LATENCY];
+    int frame_slot = 0;
+    
+    // Depth of begin_scope calls; only the outermost one runs a query
+    int open_depth = 0;
+    bool open_timed = false;
+    bool warned_nesting = false;
+    
+    GpuScopeStats stats[GPU_TIMER_MAX_NAMES];
+    int stat_count = 0;
+    
+    int    frames_timed   = 0;
+    int    frames_dropped = 0;
+    double last_frame_ms  = 0.0;
+    double total_frame_ms = 0.0;
+    
+    int find_stat(const char *name);
+    void collect(int slot);
+    
+public:
+    GpuTimer();
+    ~GpuTimer();
+    
+    void begin_frame();
+    void begin_scope(const char *name);
+    void end_scope();
+    
+    // cpu_ms is the CPU's share of the same frame, for the CPU/GPU-bound verdict
+    void log_frame(double cpu_ms) const;
+    void report() const;
+    
+    bool const is_supported() const { return supported; };
+    // Sum of one frame's passes, GPU_TIMER_LATENCY frames old; zero until timed
+    double const get_last_frame_ms() const { return last_frame_ms; };
+    double get_last_ms(const char *name) const;
+};
+
+// Closes the scope when it leaves C++ scope, so early returns stay balanced
+class GpuScope
+{
+private:
+    GpuTimer *timer;
+    
+public:
+    GpuScope(GpuTimer *gpu_timer, const char *name) : timer(gpu_timer) { if (timer != NULL) timer->begin_scope(name); };
+    ~GpuScope() { if (timer != NULL) timer->end_scope(); };
+};
@@ -0,0 +1,295 @@
+#include "cmath"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "LanderBatch.h"
+
+// Mirrors FIXED_TIMESTEP and the level set up in project_3/main.cpp
+const float LANDER_TIMESTEP = 0.0166666f;
+const float LANDER_SIZE     = 1.0f;
+
+const int   LANDER_PLATFORM_COUNT = 2;
+const float PLATFORM_X[]      = {2.25f, 4.0f};
+const float PLATFORM_Y[]      = {-3.8f, -1.9f};
+const float PLATFORM_WIDTH[]  = {1.0f, 2.0f};
+const float PLATFORM_HEIGHT[] = {3.0f, 4.0f};
+
+const float TARGET_MAX_Y = -1.0f;
+const float TARGET_MIN_X = 2.25f;
+const float OUT_OF_BOUNDS_Y = -4.5f;
+const float OUT_OF_BOUNDS_X =  5.5f;
+
+const int LANES_PER_INSTANCE = 8;
+
+LanderBatch::LanderBatch(int instance_count, int threads)
+{
+    count        = instance_count;
+    padded_count = (instance_count + LANDER_LANE_WIDTH - 1) / LANDER_LANE_WIDTH * LANDER_LANE_WIDTH;
+    thread_count = threads > 0 ? threads : (int) std::thread::hardware_concurrency();
+    if (thread_count < 1) thread_count = 1;
+    
+    lanes.assign((size_t) padded_count * LANES_PER_INSTANCE, 0.0f);
+    position_x        = lanes.data();
+    position_y        = position_x + padded_count;
+    velocity_x        = position_y + padded_count;
+    velocity_y        = velocity_x + padded_count;
+    acceleration_x    = velocity_y + padded_count;
+    acceleration_y    = acceleration_x + padded_count;
+    side_acceleration = acceleration_y + padded_count;
+    thrust            = side_acceleration + padded_count;
+    
+    // Padding lanes start finished, so they never change state
+    outcome.assign(padded_count, LANDER_LOST);
+    end_step.assign(padded_count, 0);
+    
+    reset_all(LanderParameters());
+}
+
+void LanderBatch::reset(int index, const LanderParameters& parameters)
+{
+    position_x[index]        = parameters.start_x;
+    position_y[index]        = parameters.start_y;
+    velocity_x[index]        = 0.0f;
+    velocity_y[index]        = 0.0f;
+    acceleration_x[index]    = 0.0f;
+    acceleration_y[index]    = parameters.gravity;
+    side_acceleration[index] = parameters.side_acceleration;
+    thrust[index]            = parameters.thrust;
+    outcome[index]           = LANDER_FLYING;
+    end_step[index]          = 0;
+}
+
+void LanderBatch::reset_all(const LanderParameters& parameters)
+{
+    for (int i = 0; i < count; i++) reset(i, parameters);
+    steps_run = 0;
+}
+
+void LanderBatch::record_trajectories(int interval, int max_steps)
+{
+    trajectory_interval = interval;
+    trajectory_samples  = 0;
+    
+    size_t samples = interval > 0 ? max_steps / interval : 0;
+    trajectory_x.assign(samples * padded_count, 0.0f);
+    trajectory_y.assign(samples * padded_count, 0.0f);
+}
+
+// Scratch lanes for one chunk: the step's state before it is committed, and
+// which contacts the step reported to ContactQueue. Only an overlap that was
+// resolved counts, so wall is set by an x pass that moved the lander and
+// landed by a y pass that stopped it falling.
+struct StepLanes
+{
+    float x[LANDER_CHUNK_SIZE];
+    float y[LANDER_CHUNK_SIZE];
+    float velocity_x[LANDER_CHUNK_SIZE];
+    float velocity_y[LANDER_CHUNK_SIZE];
+    float acceleration_x[LANDER_CHUNK_SIZE];
+    int   wall[LANDER_CHUNK_SIZE];
+    int   landed[LANDER_CHUNK_SIZE];
+};
+
+// check_collision_y against one platform. Selects are kept two-way, and
+// compares that only guard a select use the quiet std::isless family; longer
+// ?: chains and signalling compares turn into branches the vectoriser skips.
+void resolve_y(StepLanes& step, int platform, int n)
+{
+    float* __restrict x  = step.x;
+    float* __restrict y  = step.y;
+    float* __restrict vy = step.velocity_y;
+    int*   __restrict landed = step.landed;
+    
+    const float px = PLATFORM_X[platform], py = PLATFORM_Y[platform];
+    const float reach_x = (LANDER_SIZE + PLATFORM_WIDTH[platform])  / 2.0f;
+    const float reach_y = (LANDER_SIZE + PLATFORM_HEIGHT[platform]) / 2.0f;
+    
+    for (int j = 0; j < n; j++)
+    {
+        float x_distance = fabs(x[j] - px) - reach_x;
+        float y_distance = fabs(y[j] - py) - reach_y;
+        int hit = (x_distance < 0.0f) & (y_distance < 0.0f);
+        
+        float distance = fabs(y[j] - py);
+        float overlap  = fabs(distance - (LANDER_SIZE / 2.0f) - (PLATFORM_HEIGHT[platform] / 2.0f));
+        float shift    = vy[j] > 0 ? -overlap : overlap;
+        shift = vy[j] != 0 ? shift : 0.0f;
+        
+        landed[j] = landed[j] | (hit & std::isless(vy[j], 0.0f));
+        
+        y[j]  = hit ? y[j] + shift : y[j];
+        vy[j] = hit ? 0.0f : vy[j];
+    }
+}
+
+// check_collision_x against one platform
+void resolve_x(StepLanes& step, int platform, int n)
+{
+    float* __restrict x  = step.x;
+    float* __restrict y  = step.y;
+    float* __restrict vx = step.velocity_x;
+    int*   __restrict wall = step.wall;
+    
+    const float px = PLATFORM_X[platform], py = PLATFORM_Y[platform];
+    const float reach_x = (LANDER_SIZE + PLATFORM_WIDTH[platform])  / 2.0f;
+    const float reach_y = (LANDER_SIZE + PLATFORM_HEIGHT[platform]) / 2.0f;
+    
+    for (int j = 0; j < n; j++)
+    {
+        float x_distance = fabs(x[j] - px) - reach_x;
+        float y_distance = fabs(y[j] - py) - reach_y;
+        int hit = (x_distance < 0.0f) & (y_distance < 0.0f);
+        
+        float distance = fabs(x[j] - px);
+        float overlap  = fabs(distance - (LANDER_SIZE / 2.0f) - (PLATFORM_WIDTH[platform] / 2.0f));
+        float shift    = vx[j] > 0 ? -overlap : overlap;
+        shift = vx[j] != 0 ? shift : 0.0f;
+        
+        wall[j] = wall[j] | (hit & std::islessgreater(vx[j], 0.0f));
+        
+        x[j]  = hit ? x[j] + shift : x[j];
+        vx[j] = hit ? 0.0f : vx[j];
+    }
+}
+
+// handle_contacts, where a wall loses before any landing is looked at and a
+// landing is judged by where the step left the lander, then the bounds check,
+// which only applies if no contact decided the round. Finished instances are
+// frozen, like the deactivated player.
+void commit(const StepLanes& step, float* __restrict px, float* __restrict py, float* __restrict vx, float* __restrict vy, float* __restrict ax,
+            int* __restrict result, int* __restrict ended, int n, int absolute_step)
+{
+    const float* __restrict x   = step.x;
+    const float* __restrict y   = step.y;
+    const float* __restrict nvx = step.velocity_x;
+    const float* __restrict nvy = step.velocity_y;
+    const float* __restrict nax = step.acceleration_x;
+    const int* __restrict wall   = step.wall;
+    const int* __restrict landed = step.landed;
+    
+    for (int j = 0; j < n; j++)
+    {
+        int on_target = std::isless(y[j], TARGET_MAX_Y) & std::isgreaterequal(x[j], TARGET_MIN_X);
+        int verdict   = on_target ? LANDER_WON : LANDER_LOST;
+        int decision  = landed[j] ? verdict : LANDER_FLYING;
+        decision = wall[j] ? LANDER_LOST : decision;
+        
+        int out_of_bounds = std::isless(y[j], OUT_OF_BOUNDS_Y) | std::isless(x[j], -OUT_OF_BOUNDS_X) | std::isgreater(x[j], OUT_OF_BOUNDS_X);
+        int decided = (decision == LANDER_FLYING) & out_of_bounds ? LANDER_LOST : decision;
+        
+        int flying = result[j] == LANDER_FLYING;
+        px[j] = flying ? x[j]   : px[j];
+        py[j] = flying ? y[j]   : py[j];
+        vx[j] = flying ? nvx[j] : vx[j];
+        vy[j] = flying ? nvy[j] : vy[j];
+        ax[j] = flying ? nax[j] : ax[j];
+        ended[j]  = flying & (decided != LANDER_FLYING) ? absolute_step : ended[j];
+        result[j] = flying ? decided : result[j];
+    }
+}
+
+// One step is process_input, Entity::update, handle_contacts and the bounds
+// check, split into simple lane-wise passes over the chunk. The expressions
+// keep Entity's operation order so results match the game bit for bit.
+void LanderBatch::run_chunk(int first, int last, const unsigned char *inputs, int steps)
+{
+    int n = last - first;
+    
+    float* __restrict px   = position_x + first;
+    float* __restrict py   = position_y + first;
+    float* __restrict vx   = velocity_x + first;
+    float* __restrict vy   = velocity_y + first;
+    float* __restrict ax   = acceleration_x + first;
+    const float* __restrict ay   = acceleration_y + first;
+    const float* __restrict side = side_acceleration + first;
+    const float* __restrict push = thrust + first;
+    int* __restrict result = outcome.data() + first;
+    int* __restrict ended  = end_step.data() + first;
+    
+    // Allocated once per chunk, not per step
+    std::vector<StepLanes> step_lanes(1);
+    StepLanes& lanes_now = step_lanes[0];
+    
+    for (int step = 0; step < steps; step++)
+    {
+        const unsigned char* __restrict input = inputs + (size_t) step * count + first;
+        int absolute_step = steps_run + step + 1;
+        
+        float* __restrict x  = lanes_now.x;
+        float* __restrict y  = lanes_now.y;
+        float* __restrict nvx = lanes_now.velocity_x;
+        float* __restrict nvy = lanes_now.velocity_y;
+        float* __restrict nax = lanes_now.acceleration_x;
+        
+        // process_input (A wins over D, W kicks the velocity directly), then
+        // Entity::update's integration; movement is always zero for the lander
+        for (int j = 0; j < n; j++)
+        {
+            int keys = input[j];
+            float side_push = (keys & LANDER_RIGHT) ? side[j] : 0.0f;
+            side_push = (keys & LANDER_LEFT) ? -side[j] : side_push;
+            
+            nax[j] = ax[j] + side_push;
+            nvy[j] = vy[j] + ((keys & LANDER_THRUST) ? push[j] : 0.0f);
+            nvx[j] = 0.0f + nax[j] * LANDER_TIMESTEP;
+            nvy[j] += ay[j] * LANDER_TIMESTEP;
+            
+            x[j] = px[j];
+            y[j] = py[j] + nvy[j] * LANDER_TIMESTEP;
+            
+            lanes_now.wall[j]   = 0;
+            lanes_now.landed[j] = 0;
+        }
+        
+        for (int p = 0; p < LANDER_PLATFORM_COUNT; p++) resolve_y(lanes_now, p, n);
+        
+        for (int j = 0; j < n; j++) x[j] += nvx[j] * LANDER_TIMESTEP;
+        
+        for (int p = 0; p < LANDER_PLATFORM_COUNT; p++) resolve_x(lanes_now, p, n);
+        
+        commit(lanes_now, px, py, vx, vy, ax, result, ended, n, absolute_step);
+        
+        if (trajectory_interval > 0 && absolute_step % trajectory_interval == 0)
+        {
+            size_t sample = absolute_step / trajectory_interval - 1;
+            if (sample < trajectory_x.size() / padded_count)
+            {
+                float* __restrict tx = trajectory_x.data() + sample * padded_count + first;
+                float* __restrict ty = trajectory_y.data() + sample * padded_count + first;
+                for (int j = 0; j < n; j++)
+                {
+                    tx[j] = px[j];
+                    ty[j] = py[j];
+                }
+            }
+        }
+    }
+}
+
+void LanderBatch::run(const unsigned char *inputs, int steps)
+{
+    std::atomic<int> next_chunk(0);
+    int chunk_count = (count + LANDER_CHUNK_SIZE - 1) / LANDER_CHUNK_SIZE;
+    
+    // Each chunk runs every step before the next is claimed, keeping its
+    // lanes hot in cache; instances never interact, so chunks need no sync
+    auto worker = [&]() {
+        for (int chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+        {
+            int first = chunk * LANDER_CHUNK_SIZE;
+            int last  = first + LANDER_CHUNK_SIZE < count ? first + LANDER_CHUNK_SIZE : count;
+            run_chunk(first, last, inputs, steps);
+        }
+    };
+    
+    int worker_count = thread_count < chunk_count ? thread_count : chunk_count;
+    std::vector<std::thread> workers;
+    for (int i = 1; i < worker_count; i++) workers.push_back(std::thread(worker));
+    worker();
+    for (int i = 0; i < (int) workers.size(); i++) workers[i].join();
+    
+    steps_run += steps;
+    if (trajectory_interval > 0) trajectory_samples = steps_run / trajectory_interval;
+    size_t capacity = padded_count > 0 ? trajectory_x.size() / padded_count : 0;
+    if ((size_t) trajectory_samples > capacity) trajectory_samples = (int) capacity;
+}
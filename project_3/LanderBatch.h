@@ -0,0 +1,77 @@
+const int LANDER_LANE_WIDTH  = 8;
+const int LANDER_CHUNK_SIZE  = 1024;
+
+enum LanderOutcome { LANDER_FLYING, LANDER_WON, LANDER_LOST };
+
+// One byte of input per instance per step, matching the keys process_input reads
+enum LanderInput { LANDER_LEFT = 1, LANDER_RIGHT = 2, LANDER_THRUST = 4 };
+
+struct LanderParameters
+{
+    float start_x           = -4.0f;
+    float start_y           =  4.0f;
+    float gravity           = -1.5f;
+    float side_acceleration =  0.5f;
+    float thrust            =  0.05f;
+};
+
+// Runs many independent copies of the project_3 lander without a window:
+// the same gravity, A/D acceleration, W thrust, platform collisions and
+// win/lose rules as main.cpp, one fixed step per input. State is kept as
+// structure-of-arrays padded to LANDER_LANE_WIDTH so each step is a
+// branch-free loop the compiler can vectorise, and blocks of
+// LANDER_CHUNK_SIZE instances are handed out to worker threads.
+class LanderBatch
+{
+private:
+    int count;
+    int padded_count;
+    int thread_count;
+    int steps_run = 0;
+    
+    // Padded lanes for x, y, vx, vy, ax, ay and the three per-instance parameters
+    std::vector<float> lanes;
+    float *position_x;
+    float *position_y;
+    float *velocity_x;
+    float *velocity_y;
+    float *acceleration_x;
+    float *acceleration_y;
+    float *side_acceleration;
+    float *thrust;
+    
+    std::vector<int> outcome;
+    std::vector<int> end_step;
+    
+    int trajectory_interval = 0;
+    int trajectory_samples  = 0;
+    std::vector<float> trajectory_x;
+    std::vector<float> trajectory_y;
+    
+    void run_chunk(int first, int last, const unsigned char *inputs, int steps);
+    
+public:
+    LanderBatch(int instance_count, int threads = 0);
+    
+    void reset(int index, const LanderParameters& parameters);
+    void reset_all(const LanderParameters& parameters);
+    
+    // Records every instance's position every `interval` steps of the next
+    // run; 0 turns recording off
+    void record_trajectories(int interval, int max_steps);
+    
+    // inputs holds steps rows of instance_count bytes, row-major by step
+    void run(const unsigned char *inputs, int steps);
+    
+    int const get_count() const { return count; };
+    LanderOutcome const get_outcome(int index)  const { return (LanderOutcome) outcome[index]; };
+    int   const get_end_step(int index)   const { return end_step[index];   };
+    float const get_position_x(int index) const { return position_x[index]; };
+    float const get_position_y(int index) const { return position_y[index]; };
+    float const get_velocity_x(int index) const { return velocity_x[index]; };
+    float const get_velocity_y(int index) const { return velocity_y[index]; };
+    
+    int const get_trajectory_samples() const { return trajectory_samples; };
+    float const get_trajectory_x(int index, int sample) const { return trajectory_x[(size_t) sample * padded_count + index]; };
+    float const get_trajectory_y(int index, int sample) const { return trajectory_y[(size_t) sample * padded_count + index]; };
+};
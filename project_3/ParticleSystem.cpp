@@ -0,0 +1,146 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include <vector>
+#include "../common/MeshRegistry.h"
+#include "RenderBackend.h"
+#include "ParticleSystem.h"
+
+const int FLOATS_PER_PARTICLE = 12;
+
+ParticleEmitter::ParticleEmitter(int max_particles)
+{
+    capacity = max_particles > MAX_PARTICLES ? MAX_PARTICLES : max_particles;
+    
+    pool = new float[capacity * 5];
+    position_x = pool;
+    position_y = pool + capacity;
+    velocity_x = pool + capacity * 2;
+    velocity_y = pool + capacity * 3;
+    lifetime   = pool + capacity * 4;
+    
+    vertices   = new float[capacity * FLOATS_PER_PARTICLE];
+    tex_coords = new float[capacity * FLOATS_PER_PARTICLE];
+    
+    // Texture coordinates never change, so they are written once for the whole pool
+    float quad_tex_coords[] = {0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+    for (int i = 0; i < capacity; i++)
+    {
+        for (int j = 0; j < FLOATS_PER_PARTICLE; j++) tex_coords[i * FLOATS_PER_PARTICLE + j] = quad_tex_coords[j];
+    }
+    
+    texture_id   = 0;
+    acceleration = glm::vec3(0.0f);
+    size         = 0.1f;
+}
+
+ParticleEmitter::~ParticleEmitter()
+{
+    delete [] pool;
+    delete [] vertices;
+    delete [] tex_coords;
+}
+
+float ParticleEmitter::random_range(float min, float max)
+{
+    // xorshift32, cheap enough to call per particle without touching rand()'s global state
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return min + (max - min) * ((seed & 0xFFFFFF) / 16777216.0f);
+}
+
+void ParticleEmitter::emit(glm::vec3 position, glm::vec3 velocity, float spread, float particle_lifetime, int amount)
+{
+    if (amount > capacity - count) amount = capacity - count;
+    
+    for (int i = count; i < count + amount; i++)
+    {
+        position_x[i] = position.x;
+        position_y[i] = position.y;
+        velocity_x[i] = velocity.x + random_range(-spread, spread);
+        velocity_y[i] = velocity.y + random_range(-spread, spread);
+        lifetime[i]   = particle_lifetime * random_range(0.5f, 1.0f);
+    }
+    count += amount;
+}
+
+void ParticleEmitter::update(float delta_time)
+{
+    float* __restrict px = position_x;
+    float* __restrict py = position_y;
+    float* __restrict vx = velocity_x;
+    float* __restrict vy = velocity_y;
+    float* __restrict life = lifetime;
+    
+    const float ax = acceleration.x * delta_time;
+    const float ay = acceleration.y * delta_time;
+    
+    // Branch-free lanes, so the compiler emits SSE/NEON for each of these
+    for (int i = 0; i < count; i++)
+    {
+        vx[i] += ax;
+        vy[i] += ay;
+        px[i] += vx[i] * delta_time;
+        py[i] += vy[i] * delta_time;
+        life[i] -= delta_time;
+    }
+    
+    // Swap-remove dead particles with the last live one; order is irrelevant
+    int i = 0;
+    while (i < count)
+    {
+        if (life[i] > 0.0f)
+        {
+            i++;
+            continue;
+        }
+        count--;
+        px[i]   = px[count];
+        py[i]   = py[count];
+        vx[i]   = vx[count];
+        vy[i]   = vy[count];
+        life[i] = life[count];
+    }
+}
+
+void ParticleEmitter::build_vertices()
+{
+    const float half = size / 2.0f;
+    float* __restrict out = vertices;
+    
+    for (int i = 0; i < count; i++)
+    {
+        float left   = position_x[i] - half;
+        float right  = position_x[i] + half;
+        float bottom = position_y[i] - half;
+        float top    = position_y[i] + half;
+        
+        float* quad = out + i * FLOATS_PER_PARTICLE;
+        quad[0]  = left;  quad[1]  = bottom;
+        quad[2]  = right; quad[3]  = bottom;
+        quad[4]  = right; quad[5]  = top;
+        quad[6]  = left;  quad[7]  = bottom;
+        quad[8]  = left;  quad[9]  = top;
+        quad[10] = right; quad[11] = top;
+    }
+}
+
+void ParticleEmitter::render(RenderBackend *renderer)
+{
+    if (count == 0) return;
+    
+    build_vertices();
+    
+    // Positions are already in world space, so the whole emitter is one draw call
+    renderer->submit(texture_id, glm::mat4(1.0f), vertices, tex_coords, count * 6);
+}
@@ -0,0 +1,48 @@
+class RenderBackend;
+
+class ParticleEmitter
+{
+private:
+    int capacity;
+    int count = 0;
+    
+    // Structure-of-arrays pool, one contiguous block carved into lanes
+    float *pool;
+    float *position_x;
+    float *position_y;
+    float *velocity_x;
+    float *velocity_y;
+    float *lifetime;
+    
+    // Batched geometry, 6 vertices (12 floats) per particle
+    float *vertices;
+    float *tex_coords;
+    
+    unsigned int seed = 2463534242u;
+    
+    float random_range(float min, float max);
+    
+public:
+    static const int MAX_PARTICLES = 100000;
+    
+    GLuint texture_id;
+    glm::vec3 acceleration;
+    float size;
+    
+    ParticleEmitter(int max_particles);
+    
+    ~ParticleEmitter();
+    
+    // The pool is owned; a copy would free it twice
+    ParticleEmitter(const ParticleEmitter&) = delete;
+    ParticleEmitter& operator=(const ParticleEmitter&) = delete;
+    
+    void emit(glm::vec3 position, glm::vec3 velocity, float spread, float particle_lifetime, int amount);
+    void update(float delta_time);
+    void build_vertices();
+    void render(RenderBackend *renderer);
+    void clear() { count = 0; };
+    
+    int const get_count()    const { return count;    };
+    int const get_capacity() const { return capacity; };
+};
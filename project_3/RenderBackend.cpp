@@ -0,0 +1,67 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+#include <vector>
+#include "../common/MeshRegistry.h"
+#include "RenderBackend.h"
+
+void RenderBackend::submit_mesh(GLuint texture_id, const glm::mat4& model_matrix, MeshHandle mesh, const float *tex_coords)
+{
+    if (tex_coords == NULL) tex_coords = MeshRegistry::get_tex_coords(mesh);
+    submit(texture_id, model_matrix, MeshRegistry::get_positions(mesh), tex_coords, MeshRegistry::get_vertex_count(mesh));
+}
+
+GLRenderBackend::GLRenderBackend(ShaderProgram *shader_program)
+{
+    program = shader_program;
+}
+
+void GLRenderBackend::begin_frame()
+{
+    glUseProgram(program->programID);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void GLRenderBackend::set_view_projection(const glm::mat4& view_matrix, const glm::mat4& projection_matrix)
+{
+    program->SetViewMatrix(view_matrix);
+    program->SetProjectionMatrix(projection_matrix);
+}
+
+void GLRenderBackend::submit(GLuint texture_id, const glm::mat4& model_matrix, const float *positions, const float *tex_coords, int vertex_count)
+{
+    program->SetModelMatrix(model_matrix);
+    
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    
+    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, positions);
+    glEnableVertexAttribArray(program->positionAttribute);
+    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, tex_coords);
+    glEnableVertexAttribArray(program->texCoordAttribute);
+    
+    glDrawArrays(GL_TRIANGLES, 0, vertex_count);
+    
+    glDisableVertexAttribArray(program->positionAttribute);
+    glDisableVertexAttribArray(program->texCoordAttribute);
+}
+
+void GLRenderBackend::submit_mesh(GLuint texture_id, const glm::mat4& model_matrix, MeshHandle mesh, const float *tex_coords)
+{
+    program->SetModelMatrix(model_matrix);
+    
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    
+    MeshRegistry::draw(mesh, program->positionAttribute, program->texCoordAttribute, tex_coords);
+}
+
+void GLRenderBackend::end_frame()
+{
+}
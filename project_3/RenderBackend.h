@@ -0,0 +1,29 @@
+// Everything the games draw is a batch of textured triangles in model space;
+// a backend turns those into pixels, on the GPU or elsewhere.
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() {};
+    
+    virtual void begin_frame() = 0;
+    virtual void set_view_projection(const glm::mat4& view_matrix, const glm::mat4& projection_matrix) = 0;
+    virtual void submit(GLuint texture_id, const glm::mat4& model_matrix, const float *positions, const float *tex_coords, int vertex_count) = 0;
+    // Draws a registered mesh; backends without GPU buffers use its CPU copy
+    virtual void submit_mesh(GLuint texture_id, const glm::mat4& model_matrix, MeshHandle mesh, const float *tex_coords = NULL);
+    virtual void end_frame() = 0;
+};
+
+class GLRenderBackend : public RenderBackend
+{
+private:
+    ShaderProgram *program;
+    
+public:
+    GLRenderBackend(ShaderProgram *shader_program);
+    
+    void begin_frame();
+    void set_view_projection(const glm::mat4& view_matrix, const glm::mat4& projection_matrix);
+    void submit(GLuint texture_id, const glm::mat4& model_matrix, const float *positions, const float *tex_coords, int vertex_count);
+    void submit_mesh(GLuint texture_id, const glm::mat4& model_matrix, MeshHandle mesh, const float *tex_coords = NULL);
+    void end_frame();
+};
@@ -0,0 +1,313 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../common/MeshRegistry.h"
+#include "RenderBackend.h"
+#include "SoftwareRenderBackend.h"
+
+SoftwareRenderBackend::SoftwareRenderBackend(int framebuffer_width, int framebuffer_height, int threads)
+{
+    width   = framebuffer_width;
+    height  = framebuffer_height;
+    tiles_x = (width  + TILE_SIZE - 1) / TILE_SIZE;
+    tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+    
+    thread_count = threads > 0 ? threads : (int) std::thread::hardware_concurrency();
+    if (thread_count < 1) thread_count = 1;
+    
+    framebuffer.resize(width * height * 4);
+    bins.resize(tiles_x * tiles_y);
+    
+    view_projection = glm::mat4(1.0f);
+    
+    clear_colour[0] = clear_colour[1] = clear_colour[2] = 0;
+    clear_colour[3] = 255;
+    
+    // The thread calling end_frame works too, so it needs one fewer
+    next_tile = 0;
+    for (int i = 1; i < thread_count; i++) workers.push_back(std::thread(&SoftwareRenderBackend::run_workers, this));
+}
+
+SoftwareRenderBackend::~SoftwareRenderBackend()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    frame_ready.notify_all();
+    for (int i = 0; i < (int) workers.size(); i++) workers[i].join();
+}
+
+GLuint SoftwareRenderBackend::add_texture(const unsigned char *rgba, int texture_width, int texture_height)
+{
+    SoftwareTexture texture;
+    texture.width  = texture_width;
+    texture.height = texture_height;
+    texture.pixels.assign(rgba, rgba + texture_width * texture_height * 4);
+    textures.push_back(texture);
+    
+    // Ids start at 1 so 0 can mean "no texture", as it does in GL
+    return (GLuint) textures.size();
+}
+
+void SoftwareRenderBackend::begin_frame()
+{
+    for (int i = 0; i < width * height; i++)
+    {
+        framebuffer[i * 4 + 0] = clear_colour[0];
+        framebuffer[i * 4 + 1] = clear_colour[1];
+        framebuffer[i * 4 + 2] = clear_colour[2];
+        framebuffer[i * 4 + 3] = clear_colour[3];
+    }
+    
+    triangles.clear();
+    for (int i = 0; i < (int) bins.size(); i++) bins[i].clear();
+}
+
+void SoftwareRenderBackend::set_view_projection(const glm::mat4& view_matrix, const glm::mat4& projection_matrix)
+{
+    view_projection = projection_matrix * view_matrix;
+}
+
+void SoftwareRenderBackend::submit(GLuint texture_id, const glm::mat4& model_matrix, const float *positions, const float *tex_coords, int vertex_count)
+{
+    if (texture_id == 0 || texture_id > textures.size()) return;
+    
+    glm::mat4 transform = view_projection * model_matrix;
+    
+    for (int first = 0; first + 2 < vertex_count; first += 3)
+    {
+        SoftwareTriangle triangle;
+        triangle.texture = (int) texture_id - 1;
+        
+        for (int corner = 0; corner < 3; corner++)
+        {
+            int vertex = first + corner;
+            glm::vec4 clip = transform * glm::vec4(positions[vertex * 2], positions[vertex * 2 + 1], 0.0f, 1.0f);
+            
+            // Same mapping as glViewport(0, 0, width, height), with row 0 at the top
+            triangle.x[corner] = (clip.x / clip.w * 0.5f + 0.5f) * width;
+            triangle.y[corner] = (0.5f - clip.y / clip.w * 0.5f) * height;
+            triangle.u[corner] = tex_coords[vertex * 2];
+            triangle.v[corner] = tex_coords[vertex * 2 + 1];
+        }
+        
+        float min_x = fminf(triangle.x[0], fminf(triangle.x[1], triangle.x[2]));
+        float max_x = fmaxf(triangle.x[0], fmaxf(triangle.x[1], triangle.x[2]));
+        float min_y = fminf(triangle.y[0], fminf(triangle.y[1], triangle.y[2]));
+        float max_y = fmaxf(triangle.y[0], fmaxf(triangle.y[1], triangle.y[2]));
+        
+        if (max_x < 0.0f || max_y < 0.0f || min_x >= width || min_y >= height) continue;
+        
+        triangle.min_tile_x = min_x < 0.0f ? 0 : (int) min_x / TILE_SIZE;
+        triangle.min_tile_y = min_y < 0.0f ? 0 : (int) min_y / TILE_SIZE;
+        triangle.max_tile_x = max_x >= width  ? tiles_x - 1 : (int) max_x / TILE_SIZE;
+        triangle.max_tile_y = max_y >= height ? tiles_y - 1 : (int) max_y / TILE_SIZE;
+        
+        triangles.push_back(triangle);
+    }
+}
+
+void SoftwareRenderBackend::end_frame()
+{
+    // Binning is serial so each tile's list stays in submission order
+    for (int index = 0; index < (int) triangles.size(); index++)
+    {
+        const SoftwareTriangle& triangle = triangles[index];
+        for (int tile_y = triangle.min_tile_y; tile_y <= triangle.max_tile_y; tile_y++)
+        {
+            for (int tile_x = triangle.min_tile_x; tile_x <= triangle.max_tile_x; tile_x++)
+            {
+                bins[tile_y * tiles_x + tile_x].push_back(index);
+            }
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        next_tile    = 0;
+        workers_busy = (int) workers.size();
+        frame_number++;
+    }
+    frame_ready.notify_all();
+    
+    rasterise_tiles();
+    
+    // Tiles are only claimed, not finished, when the counter runs out
+    std::unique_lock<std::mutex> lock(mutex);
+    frame_done.wait(lock, [this]() { return workers_busy == 0; });
+}
+
+void SoftwareRenderBackend::run_workers()
+{
+    int frames_seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    
+    while (true)
+    {
+        frame_ready.wait(lock, [&]() { return frame_number != frames_seen || stopping; });
+        if (stopping) break;
+        frames_seen = frame_number;
+        lock.unlock();
+        
+        rasterise_tiles();
+        
+        lock.lock();
+        if (--workers_busy == 0) frame_done.notify_one();
+    }
+}
+
+void SoftwareRenderBackend::rasterise_tiles()
+{
+    int tile_count = tiles_x * tiles_y;
+    for (int tile = next_tile++; tile < tile_count; tile = next_tile++) rasterise_tile(tile);
+}
+
+// Of the two triangles sharing an edge, exactly one sees it running "down"
+// (or, when horizontal, "left") and claims the pixels lying on it
+static bool owns_edge(float dx, float dy, float sign)
+{
+    return dy * sign > 0.0f || (dy == 0.0f && dx * sign < 0.0f);
+}
+
+void SoftwareRenderBackend::rasterise_tile(int tile)
+{
+    const std::vector<int>& bin = bins[tile];
+    if (bin.empty()) return;
+    
+    int tile_left   = (tile % tiles_x) * TILE_SIZE;
+    int tile_top    = (tile / tiles_x) * TILE_SIZE;
+    int tile_right  = tile_left + TILE_SIZE < width  ? tile_left + TILE_SIZE : width;
+    int tile_bottom = tile_top  + TILE_SIZE < height ? tile_top  + TILE_SIZE : height;
+    
+    for (int b = 0; b < (int) bin.size(); b++)
+    {
+        const SoftwareTriangle& triangle = triangles[bin[b]];
+        const SoftwareTexture& texture = textures[triangle.texture];
+        
+        float x0 = triangle.x[0], y0 = triangle.y[0];
+        float x1 = triangle.x[1], y1 = triangle.y[1];
+        float x2 = triangle.x[2], y2 = triangle.y[2];
+        
+        float area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+        if (area == 0.0f) continue;
+        
+        // Flip clockwise triangles so one inside test covers both windings
+        float sign = area > 0.0f ? 1.0f : -1.0f;
+        float inverse_area = 1.0f / (area * sign);
+        
+        int left   = (int) fmaxf((float) tile_left,   floorf(fminf(x0, fminf(x1, x2))));
+        int right  = (int) fminf((float) tile_right,  ceilf (fmaxf(x0, fmaxf(x1, x2))));
+        int top    = (int) fmaxf((float) tile_top,    floorf(fminf(y0, fminf(y1, y2))));
+        int bottom = (int) fminf((float) tile_bottom, ceilf (fmaxf(y0, fmaxf(y1, y2))));
+        
+        for (int y = top; y < bottom; y++)
+        {
+            float sample_y = y + 0.5f;
+            unsigned char *row = &framebuffer[(y * width) * 4];
+            
+            for (int x = left; x < right; x++)
+            {
+                float sample_x = x + 0.5f;
+                
+                float w0 = sign * ((x2 - x1) * (sample_y - y1) - (y2 - y1) * (sample_x - x1));
+                float w1 = sign * ((x0 - x2) * (sample_y - y2) - (y0 - y2) * (sample_x - x2));
+                float w2 = sign * ((x1 - x0) * (sample_y - y0) - (y1 - y0) * (sample_x - x0));
+                
+                // Half-open test: pixels exactly on a shared edge go to one triangle only
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+                if ((w0 == 0.0f && !owns_edge(x2 - x1, y2 - y1, sign)) ||
+                    (w1 == 0.0f && !owns_edge(x0 - x2, y0 - y2, sign)) ||
+                    (w2 == 0.0f && !owns_edge(x1 - x0, y1 - y0, sign))) continue;
+                
+                w0 *= inverse_area;
+                w1 *= inverse_area;
+                w2 *= inverse_area;
+                
+                float u = w0 * triangle.u[0] + w1 * triangle.u[1] + w2 * triangle.u[2];
+                float v = w0 * triangle.v[0] + w1 * triangle.v[1] + w2 * triangle.v[2];
+                
+                // GL_NEAREST with GL_REPEAT
+                u -= floorf(u);
+                v -= floorf(v);
+                int texel_x = (int) (u * texture.width);
+                int texel_y = (int) (v * texture.height);
+                if (texel_x >= texture.width)  texel_x = texture.width  - 1;
+                if (texel_y >= texture.height) texel_y = texture.height - 1;
+                
+                const unsigned char *source = &texture.pixels[(texel_y * texture.width + texel_x) * 4];
+                unsigned char *destination = row + x * 4;
+                
+                // glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA), applied to all four channels
+                int alpha = source[3];
+                for (int channel = 0; channel < 4; channel++)
+                {
+                    destination[channel] = (unsigned char) ((source[channel] * alpha + destination[channel] * (255 - alpha) + 127) / 255);
+                }
+            }
+        }
+    }
+}
+
+bool SoftwareRenderBackend::save_ppm(const char *filepath) const
+{
+    FILE *file = fopen(filepath, "wb");
+    if (file == NULL) return false;
+    
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    for (int i = 0; i < width * height; i++) fwrite(&framebuffer[i * 4], 1, 3, file);
+    
+    fclose(file);
+    return true;
+}
+
+// Returns how many pixels differ from the golden image by more than
+// tolerance in any channel, or -1 when the golden is missing or the wrong size
+int SoftwareRenderBackend::compare_ppm(const char *filepath, int tolerance) const
+{
+    FILE *file = fopen(filepath, "rb");
+    if (file == NULL) return -1;
+    
+    int golden_width, golden_height, max_value;
+    if (fscanf(file, "P6 %d %d %d", &golden_width, &golden_height, &max_value) != 3 || golden_width != width || golden_height != height)
+    {
+        fclose(file);
+        return -1;
+    }
+    fgetc(file);
+    
+    std::vector<unsigned char> golden(width * height * 3);
+    size_t read = fread(golden.data(), 1, golden.size(), file);
+    fclose(file);
+    if (read != golden.size()) return -1;
+    
+    int mismatches = 0;
+    for (int i = 0; i < width * height; i++)
+    {
+        for (int channel = 0; channel < 3; channel++)
+        {
+            if (abs(framebuffer[i * 4 + channel] - golden[i * 3 + channel]) > tolerance)
+            {
+                mismatches++;
+                break;
+            }
+        }
+    }
+    return mismatches;
+}
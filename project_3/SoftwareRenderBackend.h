@@ -0,0 +1,72 @@
+struct SoftwareTexture
+{
+    int width;
+    int height;
+    std::vector<unsigned char> pixels;
+};
+
+struct SoftwareTriangle
+{
+    float x[3], y[3];
+    float u[3], v[3];
+    int texture;
+    int min_tile_x, min_tile_y, max_tile_x, max_tile_y;
+};
+
+// Rasterises submitted triangles into an in-memory RGBA8 framebuffer. The
+// screen is cut into TILE_SIZE tiles that worker threads claim one at a
+// time; inside a tile triangles are drawn in submission order, so alpha
+// blending matches the GL path. The workers start with the backend and sleep
+// between frames, so end_frame only has to wake them.
+class SoftwareRenderBackend : public RenderBackend
+{
+private:
+    int width;
+    int height;
+    int tiles_x;
+    int tiles_y;
+    int thread_count;
+    
+    std::vector<unsigned char> framebuffer;
+    std::vector<SoftwareTexture> textures;
+    std::vector<SoftwareTriangle> triangles;
+    std::vector<std::vector<int> > bins;
+    
+    glm::mat4 view_projection;
+    
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable frame_ready;
+    std::condition_variable frame_done;
+    std::atomic<int> next_tile;
+    int frame_number  = 0;
+    int workers_busy  = 0;
+    bool stopping     = false;
+    
+    void run_workers();
+    void rasterise_tiles();
+    void rasterise_tile(int tile);
+    
+public:
+    static const int TILE_SIZE = 32;
+    
+    unsigned char clear_colour[4];
+    
+    SoftwareRenderBackend(int framebuffer_width, int framebuffer_height, int threads = 0);
+    
+    ~SoftwareRenderBackend();
+    
+    GLuint add_texture(const unsigned char *rgba, int texture_width, int texture_height);
+    
+    void begin_frame();
+    void set_view_projection(const glm::mat4& view_matrix, const glm::mat4& projection_matrix);
+    void submit(GLuint texture_id, const glm::mat4& model_matrix, const float *positions, const float *tex_coords, int vertex_count);
+    void end_frame();
+    
+    bool save_ppm(const char *filepath) const;
+    int compare_ppm(const char *filepath, int tolerance) const;
+    
+    const unsigned char* get_pixels() const { return framebuffer.data(); };
+    int const get_width()  const { return width;  };
+    int const get_height() const { return height; };
+};
@@ -0,0 +1,126 @@
+#define GL_SILENCE_DEPRECATION
+#define LOG(argument) std::cout << argument << '\n'
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include "stb_image.h"
+#include <string>
+#include <vector>
+#include "../common/Texture.h"
+#include "FrameArena.h"
+#include "AllocationTracker.h"
+#include "../common/MeshRegistry.h"
+#include "RenderBackend.h"
+#include "Utility.h"
+
+const int FONTBANK_SIZE = 16;
+
+const int NUMBER_OF_TEXTURES = 1;
+const GLint LEVEL_OF_DETAIL  = 0;
+const GLint TEXTURE_BORDER   = 0;
+
+unsigned char* Utility::decode_image(const char* filepath, int* width, int* height)
+{
+    int number_of_components;
+    unsigned char* image = stbi_load(filepath, width, height, &number_of_components, STBI_rgb_alpha);
+    
+    if (image == NULL)
+    {
+        LOG("Unable to load image. Make sure the path is correct.");
+        assert(false);
+    }
+    
+    return image;
+}
+
+void Utility::free_image(unsigned char* image)
+{
+    stbi_image_free(image);
+}
+
+GLuint Utility::load_texture(const char* filepath, TextureOptions options)
+{
+    TextureInfo info = load_texture_file(filepath, options);
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    
+    return info.id;
+}
+
+GLuint Utility::create_solid_texture(unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha)
+{
+    unsigned char pixel[] = {red, green, blue, alpha};
+    
+    GLuint textureID;
+    glGenTextures(NUMBER_OF_TEXTURES, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, 1, 1, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    
+    return textureID;
+}
+
+void Utility::build_text_vertices(const std::string& text, float screen_size, float spacing, float *vertices, float *texture_coordinates)
+{
+    float width = 1.0f / FONTBANK_SIZE;
+    float height = 1.0f / FONTBANK_SIZE;
+    
+    for (int i = 0; i < text.size(); i++) {
+        int spritesheet_index = (int) text[i];
+        float offset = (screen_size + spacing) * i;
+        
+        float u_coordinate = (float) (spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE;
+        float v_coordinate = (float) (spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE;
+        
+        float glyph_vertices[] = {
+            offset + (-0.5f * screen_size), 0.5f * screen_size,
+            offset + (-0.5f * screen_size), -0.5f * screen_size,
+            offset + (0.5f * screen_size), 0.5f * screen_size,
+            offset + (0.5f * screen_size), -0.5f * screen_size,
+            offset + (0.5f * screen_size), 0.5f * screen_size,
+            offset + (-0.5f * screen_size), -0.5f * screen_size,
+        };
+        
+        float glyph_texture_coordinates[] = {
+            u_coordinate, v_coordinate,
+            u_coordinate, v_coordinate + height,
+            u_coordinate + width, v_coordinate,
+            u_coordinate + width, v_coordinate + height,
+            u_coordinate + width, v_coordinate,
+            u_coordinate, v_coordinate + height,
+        };
+        
+        for (int j = 0; j < 12; j++) {
+            vertices[i * 12 + j] = glyph_vertices[j];
+            texture_coordinates[i * 12 + j] = glyph_texture_coordinates[j];
+        }
+    }
+}
+
+void Utility::draw_text(RenderBackend *renderer, GLuint font_texture_id, const std::string& text, float screen_size, float spacing, glm::vec3 position, FrameArena *arena)
+{
+    AllocationScope scope("draw_text");
+    
+    // 6 vertices of 2 floats per glyph, released when the arena resets at the end of the frame
+    float *vertices = arena->allocate_array<float>(text.size() * 12);
+    float *texture_coordinates = arena->allocate_array<float>(text.size() * 12);
+    
+    build_text_vertices(text, screen_size, spacing, vertices, texture_coordinates);
+    
+    glm::mat4 model_matrix = glm::mat4(1.0f);
+    model_matrix = glm::translate(model_matrix, position);
+    
+    renderer->submit(font_texture_id, model_matrix, vertices, texture_coordinates, (int) (text.size() * 6));
+}
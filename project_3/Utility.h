@@ -0,0 +1,14 @@
+class FrameArena;
+class RenderBackend;
+
+class Utility
+{
+public:
+    static unsigned char* decode_image(const char* filepath, int* width, int* height);
+    static void free_image(unsigned char* image);
+    static GLuint load_texture(const char* filepath, TextureOptions options = TextureOptions());
+    static GLuint create_solid_texture(unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha);
+    
+    static void build_text_vertices(const std::string& text, float screen_size, float spacing, float *vertices, float *texture_coordinates);
+    static void draw_text(RenderBackend *renderer, GLuint font_texture_id, const std::string& text, float screen_size, float spacing, glm::vec3 position, FrameArena *arena);
+};
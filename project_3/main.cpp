@@ -1,5 +1,4 @@
 #define GL_SILENCE_DEPRECATION
-#define STB_IMAGE_IMPLEMENTATION
 #define LOG(argument) std::cout << argument << '\n'
 #define GL_GLEXT_PROTOTYPES 1
 #define FIXED_TIMESTEP 0.0166666f
@@ -14,11 +13,25 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
-#include "stb_image.h"
 #include "cmath"
 #include <ctime>
+#include <string>
 #include <vector>
+#include "../common/MeshRegistry.h"
 #include "Entity.h"
+#include "../common/Texture.h"
+#include "../common/FramePacer.h"
+#include "../common/FixedStepLoop.h"
+#include "../common/RenderTarget.h"
+#include "Utility.h"
+#include "Animation.h"
+#include "FrameArena.h"
+#include "AllocationTracker.h"
+#include "ContactEvents.h"
+#include "RenderBackend.h"
+#include "FrameCapture.h"
+#include "GpuTimer.h"
+#include "ParticleSystem.h"
 #include <SDL_mixer.h>
 
 struct GameState
@@ -28,6 +41,18 @@ struct GameState
     Entity* target;
     Entity* win;
     Entity* lose;
+    ParticleEmitter* thrust;
+    ParticleEmitter* impact;
+    AnimationSystem* animations;
+    FrameArena* frame_arena;
+    ContactQueue* contacts;
+    FrameCapture* capture;
+    int player_sprite;
+    // Held keys sampled in process_input and applied once per fixed step
+    int steering;
+    bool thrusting;
+    // Fraction of a thrust particle carried over to the next step
+    float thrust_carry;
     Mix_Music* bgm;
 };
 
@@ -44,16 +69,30 @@ const int VIEWPORT_X = 0,
           VIEWPORT_WIDTH  = WINDOW_WIDTH,
           VIEWPORT_HEIGHT = WINDOW_HEIGHT;
 
+// The scene is drawn at this size and scaled up by whole pixels to the window
+const int NATIVE_WIDTH  = 320,
+          NATIVE_HEIGHT = 240;
+
 const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
            F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
 
-const float MILLISECONDS_IN_SECOND = 1000.0;
-const int FONTBANK_SIZE = 16;
 const char TARGET[] = "assets/hand.png";
 const char OBS[] = "assets/mizore.png";
 const char PLAYER1[] = "assets/bbird.png";
 const char TEXT[] = "assets/font.png";
 
+const std::string WIN_TEXT  = "WIN",
+                  LOSE_TEXT = "LOSE";
+
+const size_t FRAME_ARENA_SIZE = 64 * 1024;
+
+const char CAPTURE_PATH[] = "capture.y4m";
+
+// bbird.png is a single cell today; widen these when it becomes a sheet
+const int PLAYER_SHEET_COLUMNS = 1,
+          PLAYER_SHEET_ROWS    = 1;
+const int PLAYER_FLY_FRAMES[]  = {0};
+
 GLuint text_texture_id;
 
 //Bird
@@ -62,102 +101,63 @@ float bird[] = {-0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, -0.5f, -0.5f, 0.5f
 float mizo[] = {-1.0f, -2.0f, 1.0f, -2.0f, 1.0f, 2.0f, -1.0f, -2.0f, -1.0f, 2.0f, 1.0f, 2.0f};
 //Hand
 float hand[] = {-0.45f, -1.5f, 0.45f, -1.5f, 0.45f, 1.5f, -0.45f, -1.5f, -0.45f, 1.5f, 0.45f, 1.5f};
+const float FULL_TEXTURE_COORDS[] = {0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+
+MeshHandle bird_mesh, mizo_mesh, hand_mesh;
 
-const int NUMBER_OF_TEXTURES = 1;
-const GLint LEVEL_OF_DETAIL  = 0;
-const GLint TEXTURE_BORDER   = 0;
+// Emitted per fixed step while W is held, so the plume does not depend on frame rate
+const float THRUST_PARTICLES_PER_SECOND = 480.0f;
+const int IMPACT_PARTICLE_COUNT = 400;
+
+// Frames between CPU/GPU timing lines on the console
+const int GPU_LOG_INTERVAL = 300;
 
 GameState state;
 
 SDL_Window* display_window;
 bool game_is_running = true;
+FramePacer pacer(60.0);
+FixedStepLoop step_loop(FIXED_TIMESTEP);
 
 ShaderProgram program;
+RenderBackend* renderer;
+RenderTarget* render_target;
+GpuTimer* gpu_timer;
 glm::mat4 view_matrix, projection_matrix;
 glm::vec3 temp;
 
-float previous_ticks = 0.0f;
-float accumulator = 0.0f;
 
-GLuint load_texture(const char* filepath)
+void end_round(Entity* result)
 {
-    int width, height, number_of_components;
-    unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
-    
-    if (image == NULL)
-    {
-        LOG("Unable to load image. Make sure the path is correct.");
-        assert(false);
-    }
-    
-    GLuint textureID;
-    glGenTextures(NUMBER_OF_TEXTURES, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
+    if (!state.player->get_active()) return;
     
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    
-    stbi_image_free(image);
-    
-    return textureID;
+    result->activate();
+    state.player->deactivate();
+    state.impact->emit(state.player->get_position(), glm::vec3(0.0f, 1.0f, 0.0f), 2.5f, 1.2f, IMPACT_PARTICLE_COUNT);
 }
 
-
-void draw_text(ShaderProgram *program, GLuint font_texture_id, std::string text, float screen_size, float spacing, glm::vec3 position)
+// Hitting a wall loses; landing wins only on the right half of the target,
+// which sits low enough that the lander comes to rest below y = -1
+void handle_contacts()
 {
-    float width = 1.0f / FONTBANK_SIZE;
-    float height = 1.0f / FONTBANK_SIZE;
-    
-    std::vector<float> vertices;
-    std::vector<float> texture_coordinates;
-
-    for (int i = 0; i < text.size(); i++) {
-        int spritesheet_index = (int) text[i];
-        float offset = (screen_size + spacing) * i;
+    // Walls are checked first so a corner that also lands still loses
+    for (int i = 0; i < state.contacts->get_event_count(); i++)
+    {
+        const ContactEvent& contact = state.contacts->get_event(i);
+        if (contact.entity != state.player || contact.phase == CONTACT_END) continue;
         
-        float u_coordinate = (float) (spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE;
-        float v_coordinate = (float) (spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE;
-
-        vertices.insert(vertices.end(), {
-            offset + (-0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-        });
-
-        texture_coordinates.insert(texture_coordinates.end(), {
-            u_coordinate, v_coordinate,
-            u_coordinate, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate + width, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate, v_coordinate + height,
-        });
+        if (contact.normal.x != 0.0f) end_round(state.lose);
     }
-
-    glm::mat4 model_matrix = glm::mat4(1.0f);
-    model_matrix = glm::translate(model_matrix, position);
-    
-    program->SetModelMatrix(model_matrix);
-    glUseProgram(program->programID);
-    
-    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, vertices.data());
-    glEnableVertexAttribArray(program->positionAttribute);
-    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, texture_coordinates.data());
-    glEnableVertexAttribArray(program->texCoordAttribute);
-    
-    glBindTexture(GL_TEXTURE_2D, font_texture_id);
-    glDrawArrays(GL_TRIANGLES, 0, (int) (text.size() * 6));
-    
-    glDisableVertexAttribArray(program->positionAttribute);
-    glDisableVertexAttribArray(program->texCoordAttribute);
+    for (int i = 0; i < state.contacts->get_event_count(); i++)
+    {
+        const ContactEvent& contact = state.contacts->get_event(i);
+        if (contact.entity != state.player || contact.phase == CONTACT_END) continue;
+        
+        if (contact.normal.y > 0.0f) {
+            end_round(contact.position.y < -1.0f && contact.position.x >= 2.25f ? state.win : state.lose);
+        }
+    }
+    state.contacts->clear_events();
 }
 
 void initialise()
@@ -170,7 +170,8 @@ void initialise()
     
     SDL_GLContext context = SDL_GL_CreateContext(display_window);
     SDL_GL_MakeCurrent(display_window, context);
-    
+    pacer.detect_vsync(display_window);
+
 #ifdef _WINDOWS
     glewInit();
 #endif
@@ -178,6 +179,9 @@ void initialise()
     glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
     
     program.Load(V_SHADER_PATH, F_SHADER_PATH);
+    renderer = new GLRenderBackend(&program);
+    render_target = new RenderTarget(NATIVE_WIDTH, NATIVE_HEIGHT, display_window);
+    gpu_timer = new GpuTimer();
     
     view_matrix = glm::mat4(1.0f);
     projection_matrix = glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f);
@@ -189,8 +193,11 @@ void initialise()
     
     glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
     
-    GLuint platform_texture_id = load_texture(TARGET);
-    GLuint obstacle_texture_id = load_texture(OBS);
+    mizo_mesh = MeshRegistry::register_mesh(mizo, FULL_TEXTURE_COORDS, 6);
+    hand_mesh = MeshRegistry::register_mesh(hand, FULL_TEXTURE_COORDS, 6);
+    
+    GLuint platform_texture_id = Utility::load_texture(TARGET);
+    GLuint obstacle_texture_id = Utility::load_texture(OBS);
     
     state.platforms = new Entity[2];
     
@@ -207,21 +214,53 @@ void initialise()
     state.platforms[1].update(0.0f, NULL, 0);
     
     state.player = new Entity();
+    state.player->set_type(PLAYER);
     state.player->set_position(glm::vec3(-4.0f, 4.0f, 0.0f));
     state.player->set_movement(glm::vec3(0.0f));
     state.player->speed = 1.0f;
     state.player->set_acceleration(glm::vec3(0.0f, -1.5f, 0.0f));
-    state.player->texture_id = load_texture(PLAYER1);
+    state.player->texture_id = Utility::load_texture(PLAYER1);
     
     state.player->set_height(1.0f);
     state.player->set_width(1.0f);
     
+    state.animations = new AnimationSystem();
+    int fly_clip = state.animations->add_clip(PLAYER_SHEET_COLUMNS, PLAYER_SHEET_ROWS, PLAYER_FLY_FRAMES, sizeof(PLAYER_FLY_FRAMES) / sizeof(int));
+    state.player_sprite = state.animations->add_sprite(fly_clip);
+    
+    // The mesh keeps the clip's first frame, so a one-frame clip never has to
+    // send its UVs from client memory
+    bird_mesh = MeshRegistry::register_mesh(bird, state.animations->get_tex_coords(state.player_sprite), 6);
+    
     state.target = &state.platforms[0];
     state.win = new Entity();
     state.lose = new Entity();
+    state.win->set_type(MARKER);
+    state.lose->set_type(MARKER);
     state.win->deactivate();
     state.lose->deactivate();
     
+    text_texture_id = Utility::load_texture(TEXT);
+    report_texture_memory();
+    state.frame_arena = new FrameArena(FRAME_ARENA_SIZE);
+    state.contacts = new ContactQueue();
+    state.capture = NULL;
+    state.steering = 0;
+    state.thrusting = false;
+    state.thrust_carry = 0.0f;
+    
+    GLuint particle_texture_id = Utility::create_solid_texture(255, 160, 40, 200);
+    
+    state.thrust = new ParticleEmitter(2000);
+    state.thrust->texture_id = particle_texture_id;
+    state.thrust->acceleration = glm::vec3(0.0f, -1.5f, 0.0f);
+    state.thrust->size = 0.08f;
+    
+    state.impact = new ParticleEmitter(4000);
+    state.impact->texture_id = particle_texture_id;
+    state.impact->acceleration = glm::vec3(0.0f, -3.0f, 0.0f);
+    state.impact->size = 0.06f;
+    
     Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096);
     state.bgm = Mix_LoadMUS("assets/bgm.mp3");
     Mix_PlayMusic(state.bgm, -1);
@@ -230,10 +269,32 @@ void initialise()
     
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    // Loading time is not simulation time
+    step_loop.reset();
+    pacer.reset();
+}
+
+void toggle_capture()
+{
+    AllocationTracker::allow_this_frame();
+    
+    if (state.capture != NULL)
+    {
+        delete state.capture;
+        state.capture = NULL;
+        return;
+    }
+    
+    int drawable_width, drawable_height;
+    SDL_GL_GetDrawableSize(display_window, &drawable_width, &drawable_height);
+    state.capture = new FrameCapture(drawable_width, drawable_height, CAPTURE_PATH);
 }
 
 void process_input()
 {
+    AllocationScope scope("process_input");
+    
     state.player->set_movement(glm::vec3(0.0f));
     
     SDL_Event event;
@@ -244,12 +305,19 @@ void process_input()
             case SDL_WINDOWEVENT_CLOSE:
                 game_is_running = false;
                 break;
-                
+            
             case SDL_KEYDOWN:
                 switch (event.key.keysym.sym) {
                     case SDLK_q:
                         game_is_running = false;
                         break;
+                    case SDLK_c:
+                        toggle_capture();
+                        break;
+                    case SDLK_r:
+                        render_target->dynamic_resolution = !render_target->dynamic_resolution;
+                        LOG("Dynamic resolution " << (render_target->dynamic_resolution ? "on" : "off"));
+                        break;
                     default:
                         break;
                 }
@@ -259,25 +327,12 @@ void process_input()
     }
     
     const Uint8* key_state = SDL_GetKeyboardState(NULL);
-
-    if (key_state[SDL_SCANCODE_A])
-    {
-        temp = state.player->get_acceleration();
-        temp.x -= 0.5f;
-        state.player->set_acceleration(temp);
-    }
-    else if (key_state[SDL_SCANCODE_D])
-    {
-        temp = state.player->get_acceleration();
-        temp.x += 0.5f;
-        state.player->set_acceleration(temp);
-    }
     
-    if (key_state[SDL_SCANCODE_W]){
-        temp = state.player->get_velocity();
-        temp.y += 0.05f;
-        state.player->set_velocity(temp);
-    }
+    if (key_state[SDL_SCANCODE_A])      state.steering = -1;
+    else if (key_state[SDL_SCANCODE_D]) state.steering = 1;
+    else                                state.steering = 0;
+    
+    state.thrusting = key_state[SDL_SCANCODE_W] && state.player->get_active();
     if (glm::length(state.player->movement) > 1.0f)
     {
         state.player->movement = glm::normalize(state.player->movement);
@@ -286,60 +341,132 @@ void process_input()
 
 void update()
 {
-    float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
-    float delta_time = ticks - previous_ticks;
-    previous_ticks = ticks;
+    AllocationScope scope("update");
+    
+    int steps = step_loop.begin_frame();
+    if (steps == 0) return;
+    
+    for (int i = 0; i < steps; i++) {
+        // Applied per step rather than per frame, so the lander handles the
+        // same at any frame rate
+        if (state.steering != 0)
+        {
+            temp = state.player->get_acceleration();
+            temp.x += 0.5f * state.steering;
+            state.player->set_acceleration(temp);
+        }
+        
+        if (state.thrusting && state.player->get_active())
+        {
+            temp = state.player->get_velocity();
+            temp.y += 0.05f;
+            state.player->set_velocity(temp);
+            
+            state.thrust_carry += THRUST_PARTICLES_PER_SECOND * FIXED_TIMESTEP;
+            int amount = (int) state.thrust_carry;
+            state.thrust_carry -= amount;
+            
+            glm::vec3 nozzle = state.player->get_position() - glm::vec3(0.0f, state.player->get_height() / 2.0f, 0.0f);
+            state.thrust->emit(nozzle, glm::vec3(0.0f, -2.0f, 0.0f) + state.player->get_velocity(), 0.4f, 0.6f, amount);
+        }
+        
+        state.player->update(FIXED_TIMESTEP, state.platforms, PLATFORM_COUNT, state.contacts);
+        state.contacts->end_step();
+        state.thrust->update(FIXED_TIMESTEP);
+        state.impact->update(FIXED_TIMESTEP);
+        state.animations->update(FIXED_TIMESTEP);
+    }
     
-    delta_time += accumulator;
+    handle_contacts();
+    
+    glm::vec3 position = state.player->get_position();
+    if(position.y < -4.5f || position.x < -5.5f || position.x > 5.5f){
+        end_round(state.lose);
+    }
+}
+
+void render()
+{
+    AllocationScope scope("render");
+    
+    gpu_timer->begin_frame();
+    render_target->begin();
+    renderer->begin_frame();
     
-    if (delta_time < FIXED_TIMESTEP)
     {
-        accumulator = delta_time;
-        return;
+        GpuScope pass(gpu_timer, "scene");
+        state.player->interpolate(step_loop.get_alpha());
+        const float *player_uvs = state.animations->is_single_frame(state.player_sprite) ? NULL : state.animations->get_tex_coords(state.player_sprite);
+        state.player->render(renderer, bird_mesh, player_uvs);
+        state.platforms[0].render(renderer, hand_mesh);
+        state.platforms[1].render(renderer, mizo_mesh);
     }
-    if(state.player->collided_left || state.player->collided_right || state.player->get_position().y < -4.5f || state.player->get_position().x < -5.5f || state.player->get_position().x > 5.5f){
-        state.lose->activate();
-        state.player->deactivate();
-    }else if((state.player->collided_bottom && state.player->get_position().y > -1.0f) || (state.player->collided_bottom && state.player->get_position().x < 2.25f)){
-        state.lose->activate();
-        state.player->deactivate();
-    }else if(state.player->collided_bottom && state.player->get_position().y < -1.0f && state.player->get_position().x >= 2.25f){
-        state.win->activate();
-        state.player->deactivate();
-    //else if(state.player->check_collision(state.target)){
-    //    state.win->activate();
-    //    state.player->deactivate();
+    {
+        GpuScope pass(gpu_timer, "particles");
+        state.thrust->render(renderer);
+        state.impact->render(renderer);
     }
-    while (delta_time >= FIXED_TIMESTEP) {
-        state.player->update(FIXED_TIMESTEP, state.platforms, PLATFORM_COUNT);
-        delta_time -= FIXED_TIMESTEP;
+    {
+        GpuScope pass(gpu_timer, "text");
+        if(state.lose->get_active()){
+            Utility::draw_text(renderer, text_texture_id, LOSE_TEXT, 0.8f, 0.5f, glm::vec3(-2.0f, 1.0f, 0.0f), state.frame_arena);
+        }else if(state.win->get_active()){
+            Utility::draw_text(renderer, text_texture_id, WIN_TEXT, 0.8f, 0.5f, glm::vec3(-1.5f, 1.0f, 0.0f), state.frame_arena);
+        }
     }
     
-    accumulator = delta_time;
+    renderer->end_frame();
+    {
+        GpuScope pass(gpu_timer, "upscale");
+        render_target->present();
+    }
+    if (state.capture != NULL)
+    {
+        GpuScope pass(gpu_timer, "capture");
+        state.capture->capture();
+    }
+    pacer.end_work();
+    SDL_GL_SwapWindow(display_window);
 }
 
-void render()
+// Once the round is over and the last particles have died nothing on screen
+// changes, so the loop can block on input instead of redrawing. A running
+// capture keeps the loop live so the recording stays at a constant rate.
+bool is_idle()
 {
-    glClear(GL_COLOR_BUFFER_BIT);
-    
-    state.player->render(&program, bird);
-    state.platforms[0].render(&program, hand);
-    state.platforms[1].render(&program, mizo);
-    text_texture_id = load_texture(TEXT);
-    if(state.lose->get_active()){
-        draw_text(&program, text_texture_id, "LOSE", 0.8f, 0.5f, glm::vec3(-2.0f, 1.0f, 0.0f));
-    }else if(state.win->get_active()){
-        draw_text(&program, text_texture_id, "WIN", 0.8f, 0.5f, glm::vec3(-1.5f, 1.0f, 0.0f));
-    }
-    SDL_GL_SwapWindow(display_window);
+    return state.capture == NULL &&
+           !state.player->get_active() &&
+           state.thrust->get_count() == 0 &&
+           state.impact->get_count() == 0;
 }
 
 void shutdown()
 {
+#ifdef TRACK_ALLOCATIONS
+    AllocationTracker::report();
+#endif
+    pacer.report();
+    step_loop.report();
+    gpu_timer->report();
+    render_target->report();
+    MeshRegistry::report();
+    
+    // Draining the capture ring still needs the GL context
+    delete state.capture;
+    delete gpu_timer;
+    delete render_target;
+    MeshRegistry::release();
+    
     SDL_Quit();
     
     delete [] state.platforms;
     delete state.player;
+    delete state.thrust;
+    delete state.impact;
+    delete state.animations;
+    delete state.frame_arena;
+    delete state.contacts;
+    delete renderer;
     Mix_FreeMusic(state.bgm);
 }
 
@@ -347,11 +474,34 @@ int main(int argc, char* argv[])
 {
     initialise();
     
+    int frame = 0;
     while (game_is_running)
     {
+        AllocationTracker::begin_frame();
+        pacer.begin_frame();
+        
         process_input();
         update();
         render();
+        
+        state.frame_arena->reset();
+        pacer.end_frame(is_idle());
+        
+        // Whichever side is slower sets the pace; the work time stops short
+        // of the swap, which under vsync would read as a full frame every frame
+        double frame_ms = pacer.get_last_work_ms();
+        if (gpu_timer->get_last_frame_ms() > frame_ms) frame_ms = gpu_timer->get_last_frame_ms();
+        render_target->update_scale(frame_ms, pacer.get_target_ms());
+        
+        // GPU results lag by GPU_TIMER_LATENCY frames, which is fine for a
+        // steady scene and keeps the read from stalling. Logged before the
+        // frame closes so anything the logging allocates is still counted.
+        if (++frame % GPU_LOG_INTERVAL == 0)
+        {
+            AllocationScope scope("gpu_log");
+            gpu_timer->log_frame(pacer.get_last_work_ms());
+        }
+        AllocationTracker::end_frame();
     }
     
     shutdown();